@@ -1,18 +1,22 @@
 #pragma once
 
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
 namespace adaptor
 {
 namespace detail
 {
 
 template <typename Range>
-using iterator_category_t = 
+using iterator_category_t =
     typename std::iterator_traits<
         typename std::remove_reference<Range>::type
     ::iterator>::iterator_category;
 
 template <typename Range>
-using difference_type_t = 
+using difference_type_t =
     typename std::iterator_traits<
         typename std::remove_reference<Range>::type
     ::iterator>::difference_type;
@@ -23,5 +27,142 @@ using value_type_t =
         typename std::remove_reference<Range>::type
     ::iterator>::value_type;
 
+template <typename Range>
+using is_random_access = std::is_same<
+    iterator_category_t<Range>, std::random_access_iterator_tag
+>;
+
+// Constrains the members of an adaptor's iterator that need random access,
+//
+//   template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+//   self_type& operator+=(difference_type n);
+//
+// so that on other iterators they aren't just unusable, but absent (and
+// so invisible to traits and SFINAE).
+template <typename Category>
+using enable_if_random_access_t = typename std::enable_if<
+    std::is_same<Category, std::random_access_iterator_tag>::value
+>::type;
+
+// The category of an adaptor that can only move forwards: forward, unless
+// the underlying range is single pass (e.g. a generator).
+template <typename Range>
+using forward_category_t = typename std::conditional<
+    std::is_base_of<std::forward_iterator_tag, iterator_category_t<Range>>::value,
+    std::forward_iterator_tag,
+    std::input_iterator_tag
+>::type;
+
+// Adaptors keep a reference to ranges passed in as lvalues, but take
+// ownership of rvalues (usually the previous stage of a pipeline), so
+// that a pipeline (or a piece of one) can outlive the expression that
+// built it.
+template <typename Range>
+using stored_range_t = typename std::conditional<
+    std::is_lvalue_reference<Range>::value,
+    Range,
+    typename std::remove_reference<Range>::type
+>::type;
+
+template <typename...>
+struct make_void
+{
+    using type = void;
+};
+
+template <typename... Ts>
+using void_t = typename make_void<Ts...>::type;
+
+// Whether a range supports the split_size() / split_range() protocol (see
+// range_split.hpp).
+template <typename Range, typename = void>
+struct is_splittable
+    : std::false_type
+{ };
+
+template <typename Range>
+struct is_splittable<
+    Range,
+    void_t<decltype(
+        std::declval<typename std::remove_reference<Range>::type&>()
+            .split_range(std::size_t(), std::size_t())
+    )>
+> 
+    : std::true_type
+{ };
+
+// Whether an adaptor split on positions in the range it wraps (filter()
+// and unique()) can be split: that range must be random access or
+// splittable itself, and readable more than once.
+template <typename Range>
+using is_position_splittable = std::integral_constant<bool,
+    (is_random_access<Range>::value || is_splittable<Range>::value)
+    && std::is_base_of<std::forward_iterator_tag, iterator_category_t<Range>>::value
+>;
+
+// Whether a range has contiguous storage: a data() member and random
+// access iterators.
+template <typename Range, typename = void>
+struct is_contiguous
+    : std::false_type
+{ };
+
+template <typename Range>
+struct is_contiguous<
+    Range,
+    void_t<decltype(std::declval<typename std::remove_reference<Range>::type&>().data())>
+>
+    : is_random_access<Range>
+{ };
+
+// Whether a pipeline contains a stage whose output depends on the order
+// elements arrive in (e.g. unique()), so that its results must be consumed
+// in order. Adaptors take the range they wrap as their first template
+// parameter, which is followed down the pipeline; order dependent stages
+// specialize this to true.
+template <typename Range>
+struct is_order_dependent
+    : std::false_type
+{ };
+
+template <
+    template <typename...> class Adaptor, typename Range, typename... Rest
+>
+struct is_order_dependent<Adaptor<Range, Rest...>>
+    : is_order_dependent<typename std::remove_reference<Range>::type>
+{ };
+
+//================================================================================
+
+// A (begin, end) pair of iterators that can be used as a range. This is
+// what the split_range() member of each splittable adaptor returns.
+template <typename Iterator>
+struct iterator_range
+{
+    using iterator   = Iterator;
+    using value_type = typename std::iterator_traits<Iterator>::value_type;
+    using reference  = typename std::iterator_traits<Iterator>::reference;
+
+    iterator_range(Iterator first, Iterator last)
+        : begin_(first),
+          end_(last)
+    { }
+
+    iterator begin() const
+    {
+        return begin_;
+    }
+
+    iterator end() const
+    {
+        return end_;
+    }
+
+private:
+
+    iterator begin_;
+    iterator end_;
+};
+
 } // end namespace detail
 } // end namespace adaptor
@@ -1,16 +1,53 @@
+#include "range_any.hpp"
+#include "range_auto_exec.hpp"
+#include "range_collect.hpp"
+#include "range_compact.hpp"
 #include "range_copy.hpp"
+#include "range_flatten.hpp"
 #include "range_map.hpp"
+#include "range_map_lut.hpp"
+#include "range_prefetch.hpp"
 #include "range_filter.hpp"
+#include "range_find.hpp"
+#include "range_group_by.hpp"
+#include "range_hash.hpp"
+#include "range_pipeline_parallel.hpp"
 #include "range_stride.hpp"
+#include "range_take.hpp"
 #include "range_unique.hpp"
+#include "range_write.hpp"
 #include "range_reverse.hpp"
+#include "range_rle.hpp"
+#include "range_sorted.hpp"
+#include "range_split.hpp"
+#include "range_top_k.hpp"
+
+#if __cplusplus >= 201703L
+#include "range_cache.hpp"
+#endif
+
+#if __cplusplus >= 202002L
+#include "range_generator.hpp"
+#endif
 
 #include <algorithm>
 #include <iostream>
+#include <string>
 #include <vector>
 
 using namespace adaptor;
 
+#if __cplusplus >= 202002L
+adaptor::generator<int> repeat_each(int n, int times)
+{
+    for(int i = 0; i < n; ++i) {
+        for(int j = 0; j < times; ++j) {
+            co_yield i;
+        }
+    }
+}
+#endif
+
 int main()
 {
     std::vector<int> x = { 1,2,3,4,5,6,7,8,9,10 };
@@ -65,4 +102,169 @@ int main()
         std::cout << v << ", ";
     }
     std::cout << '\n';
+
+    auto halves = adaptor::split_at(mp, 2);
+    for(auto v : halves.first) {
+        std::cout << v << ", ";
+    }
+    std::cout << "| ";
+    for(auto v : halves.second) {
+        std::cout << v << ", ";
+    }
+    std::cout << '\n';
+
+    for(auto piece : adaptor::split(uq, 3)) {
+        for(auto v : piece) {
+            std::cout << v << ", ";
+        }
+        std::cout << "| ";
+    }
+    std::cout << '\n';
+
+    std::vector<int> table = { 100, 200, 300, 400, 500, 600, 700, 800, 900, 1000 };
+    std::vector<int> indices = { 9, 0, 4, 4, 7, 1 };
+    auto gather = indices 
+        | adaptor::prefetch(2, [&table](int i) { return &table[i]; })
+        | adaptor::map([&table](int i) { return table[i]; });
+
+    for(auto v : gather) {
+        std::cout << v << ", ";
+    }
+    std::cout << '\n';
+
+    auto best = x | adaptor::filter([](int x) { return x % 2 == 0; })
+                  | adaptor::map([](int x) { return x * x; })
+                  | adaptor::top_k(3);
+
+    for(auto v : best) {
+        std::cout << v << ", ";
+    }
+    std::cout << '\n';
+
+    for(auto group : y | adaptor::group_by([](int x) { return x / 2; })) {
+        std::cout << group.first << ": [ ";
+        for(auto v : group.second) {
+            std::cout << v << " ";
+        }
+        std::cout << "], ";
+    }
+    std::cout << '\n';
+
+    auto sums = y | adaptor::aggregate_by(
+        [](int x) { return x / 2; }, [](int acc, int x) { return acc + x; }, 0
+    );
+    for(const auto& sum : sums) {
+        std::cout << sum.first << ": " << sum.second << ", ";
+    }
+    std::cout << '\n';
+
+    std::vector<std::vector<int>> nested = { { 1, 2 }, { }, { 3 }, { 4, 5, 6 } };
+    for(auto v : nested | adaptor::flatten() | adaptor::map([](int x) { return x * 10; })) {
+        std::cout << v << ", ";
+    }
+    std::cout << '\n';
+
+    auto flat = nested | adaptor::flatten() | adaptor::collect();
+    for(auto v : flat) {
+        std::cout << v << ", ";
+    }
+    std::cout << '\n';
+
+    auto pipelined = y | adaptor::map([](int x) { return x * 3; })
+                       | adaptor::pipeline_parallel()
+                       | adaptor::unique();
+
+    for(auto v : pipelined) {
+        std::cout << v << ", ";
+    }
+    std::cout << '\n';
+
+    std::vector<int> odds;
+    auto count = x | adaptor::filter([](int x) { return x % 2 == 1; })
+                   | adaptor::compact_into(odds);
+
+    std::cout << count << ": ";
+    for(auto v : odds) {
+        std::cout << v << ", ";
+    }
+    std::cout << '\n';
+
+    std::string word = "lookup";
+    for(auto c : word | adaptor::map_lut([](char c) { return char(c - 'a' + 'A'); })) {
+        std::cout << c;
+    }
+    std::cout << '\n';
+
+    for(auto v : x | adaptor::drop_while([](int x) { return x < 3; })
+                   | adaptor::take_while([](int x) { return x < 8; })
+                   | adaptor::take(3)) {
+        std::cout << v << ", ";
+    }
+    std::cout << '\n';
+
+    auto first = x | adaptor::map([](int x) { return x * x; })
+                   | adaptor::find_first([](int x) { return x > 20; });
+    if(first) {
+        std::cout << first.value << '\n';
+    }
+
+    std::vector<int> column{ 7, 7, 7, 7, 3, 3, 9, 9, 9, 9, 9, 9 };
+    auto runs = column | adaptor::rle() | adaptor::collect();
+    for(auto v : adaptor::from_rle(runs) | adaptor::stride(3)) {
+        std::cout << v << ", ";
+    }
+    std::cout << '(' << runs.size() << " runs)\n";
+
+    std::vector<int> scrambled{ 4, -2, 9, 4, 0, -2, 9, 9 };
+    for(auto v : scrambled | adaptor::sorted() | adaptor::unique()) {
+        std::cout << v << ", ";
+    }
+    std::cout << '\n';
+
+    std::cout << std::hex
+              << (x | adaptor::filter([](int x) { return x % 2 == 0; }) | adaptor::hash_into()) << ' '
+              << (x | adaptor::crc32c()) << std::dec << '\n';
+
+    x | adaptor::map([](int x) { return x * 1.5; })
+      | adaptor::write_to<adaptor::write_format::text>(stdout, adaptor::write_options{ ' ' });
+    std::cout << std::endl;
+
+    std::vector<adaptor::any_range<int>> views;
+    views.emplace_back(x | adaptor::map([](int x) { return x * x; }));
+    views.emplace_back(x | adaptor::filter([](int x) { return x % 3 == 0; }));
+    views.emplace_back(scrambled | adaptor::sorted() | adaptor::unique());
+    for(auto& view : views) {
+        for(auto v : view) {
+            std::cout << v << ", ";
+        }
+        std::cout << '\n';
+    }
+
+    long long total = 0;
+    x | adaptor::map([](int x) { return x * x; })
+      | adaptor::auto_exec([&](int x) { total += x; }, &std::cout);
+    std::cout << total << '\n';
+
+#if __cplusplus >= 201703L
+    char buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+    {
+        auto cached = x | adaptor::filter([](int x) { return x % 3 == 0; })
+                        | adaptor::map([](int x) { return x * 100; })
+                        | adaptor::cache(arena);
+
+        for(auto v : cached | adaptor::reverse()) {
+            std::cout << v << ", ";
+        }
+        std::cout << '\n';
+    }
+    arena.release();
+#endif
+
+#if __cplusplus >= 202002L
+    for(auto v : repeat_each(10, 3) | adaptor::unique() | adaptor::stride(3)) {
+        std::cout << v << ", ";
+    }
+    std::cout << '\n';
+#endif
 }
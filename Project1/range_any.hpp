@@ -0,0 +1,360 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace adaptor
+{
+
+template <typename T>
+struct any_range;
+
+namespace detail
+{
+
+// What any_range knows about the range it holds. Elements come out in
+// batches, so iterating costs one virtual call per batch rather than
+// several per element.
+template <typename T>
+struct any_range_concept
+{
+    virtual ~any_range_concept() = default;
+
+    // Moves back to the start of the range.
+    virtual void start() = 0;
+
+    // Constructs up to n of the next elements in the raw storage at out,
+    // returning how many; fewer than n means the range has ended.
+    virtual std::size_t pull(T* out, std::size_t n) = 0;
+
+    // Moves the range (not the position in it) into raw storage of the
+    // inline size.
+    virtual any_range_concept* move_to(void* buffer) = 0;
+};
+
+template <typename T, typename Range>
+struct any_range_model final
+    : public any_range_concept<T>
+{
+private:
+
+    using iterator = typename std::remove_reference<Range>::type::iterator;
+
+public:
+
+    explicit any_range_model(Range&& r)
+        : range_(std::forward<Range>(r)),
+          started_(false)
+    { }
+
+    ~any_range_model() override
+    {
+        stop();
+    }
+
+    void start() override
+    {
+        stop();
+        new (&first_) iterator(range_.begin());
+        new (&last_) iterator(range_.end());
+        started_ = true;
+    }
+
+    std::size_t pull(T* out, std::size_t n) override
+    {
+        auto& first = reinterpret_cast<iterator&>(first_);
+        auto& last  = reinterpret_cast<iterator&>(last_);
+
+        std::size_t i = 0;
+        try {
+            for(; i != n && first != last; ++first, ++i) {
+                new (out + i) T(*first);
+            }
+        }
+        catch(...) {
+            for(std::size_t j = 0; j != i; ++j) { out[j].~T(); }
+            throw;
+        }
+        return i;
+    }
+
+    any_range_concept<T>* move_to(void* buffer) override
+    {
+        return new (buffer) any_range_model(std::forward<Range>(range_));
+    }
+
+private:
+
+    void stop()
+    {
+        if(!started_) { return; }
+        reinterpret_cast<iterator&>(first_).~iterator();
+        reinterpret_cast<iterator&>(last_).~iterator();
+        started_ = false;
+    }
+
+    stored_range_t<Range>                                           range_;
+    std::aligned_storage_t<sizeof(iterator), alignof(iterator)>     first_;
+    std::aligned_storage_t<sizeof(iterator), alignof(iterator)>     last_;
+    bool                                                            started_;
+};
+
+template <typename T>
+struct any_range_iterator
+    : public std::iterator<std::input_iterator_tag, T>
+{
+private:
+
+    using self_type = any_range_iterator<T>;
+
+public:
+
+    using reference = const T&;
+
+    explicit any_range_iterator(any_range<T>* parent)
+        : parent_(parent)
+    { }
+
+    reference operator*() const
+    {
+        return parent_->current();
+    }
+
+    self_type& operator++()
+    {
+        parent_->advance();
+        return *this;
+    }
+
+    self_type operator++(int)
+    {
+        self_type ret(*this);
+        parent_->advance();
+        return ret;
+    }
+
+    bool at_end() const
+    {
+        return parent_ == nullptr || parent_->done_;
+    }
+
+    bool equals(const self_type& other) const
+    {
+        return at_end() == other.at_end();
+    }
+
+private:
+
+    any_range<T>* parent_;
+};
+
+template <typename T>
+bool operator==(const any_range_iterator<T>& r1, const any_range_iterator<T>& r2)
+{
+    return r1.equals(r2);
+}
+
+template <typename T>
+bool operator!=(const any_range_iterator<T>& r1, const any_range_iterator<T>& r2)
+{
+    return !operator==(r1, r2);
+}
+
+template <typename Range, typename T>
+using enable_if_not_any_range_t = std::enable_if_t<
+    !std::is_same<std::decay_t<Range>, any_range<T>>::value
+>;
+
+} // end namespace detail
+
+// Holds any range whose elements convert to T, behind a single type: e.g.
+// pipelines built in different ways can be kept in one container, or
+// passed to code that doesn't know how they were built.
+//
+// Ranges that fit in inline_size bytes (most pipelines of a few stages)
+// are stored inline, anything bigger on the heap. Ranges held by reference
+// (lvalues) must outlive the any_range, as with any adaptor. Iterating
+// pulls batch_bytes worth of elements at a time into a buffer in the
+// any_range, and the iterators refer to that buffer, so an any_range is a
+// single pass range per begin(), and must not be moved while iterated.
+// Moving one leaves it empty.
+template <typename T>
+struct any_range
+{
+    friend struct detail::any_range_iterator<T>;
+
+    static constexpr std::size_t inline_size = 256;
+    static constexpr std::size_t batch_bytes = 1024;
+
+public:
+
+    using iterator   = detail::any_range_iterator<T>;
+    using value_type = T;
+    using reference  = const T&;
+
+    template <typename Range, typename = detail::enable_if_not_any_range_t<Range, T>>
+    any_range(Range&& r)
+        : inline_(false),
+          size_(0),
+          position_(0),
+          done_(true)
+    {
+        using model_type = detail::any_range_model<T, Range>;
+
+        construct<model_type>(std::forward<Range>(r), std::integral_constant<bool,
+            fits_inline<model_type, Range>()
+        >());
+    }
+
+    any_range(any_range&& other)
+        : inline_(other.inline_),
+          size_(0),
+          position_(0),
+          done_(true)
+    {
+        if(other.impl_ == nullptr) {
+            impl_   = nullptr;
+            inline_ = false;
+        }
+        else if(inline_) {
+            impl_ = other.impl_->move_to(&storage_);
+            other.reset();
+        }
+        else {
+            impl_ = other.impl_;
+        }
+        other.clear();
+        other.impl_   = nullptr;
+        other.inline_ = false;
+        other.done_   = true;
+    }
+
+    any_range& operator=(any_range&& other)
+    {
+        if(this != &other) {
+            this->~any_range();
+            new (this) any_range(std::move(other));
+        }
+        return *this;
+    }
+
+    any_range(const any_range&) = delete;
+    any_range& operator=(const any_range&) = delete;
+
+    ~any_range()
+    {
+        clear();
+        reset();
+    }
+
+    // A moved-from any_range is empty.
+    iterator begin()
+    {
+        clear();
+        if(impl_ == nullptr) {
+            done_ = true;
+            return iterator(this);
+        }
+        impl_->start();
+        done_ = false;
+        refill();
+        return iterator(this);
+    }
+
+    iterator end()
+    {
+        return iterator(nullptr);
+    }
+
+private:
+
+    static constexpr std::size_t batch_size =
+        sizeof(T) >= batch_bytes ? 1 : batch_bytes / sizeof(T);
+
+    // Inline ranges are moved when the any_range is, which mustn't throw.
+    template <typename Model, typename Range>
+    static constexpr bool fits_inline()
+    {
+        return sizeof(Model) <= inline_size
+            && alignof(Model) <= alignof(std::max_align_t)
+            && std::is_nothrow_move_constructible<detail::stored_range_t<Range>>::value;
+    }
+
+    template <typename Model, typename Range>
+    void construct(Range&& r, std::true_type)
+    {
+        impl_   = new (&storage_) Model(std::forward<Range>(r));
+        inline_ = true;
+    }
+
+    template <typename Model, typename Range>
+    void construct(Range&& r, std::false_type)
+    {
+        impl_ = new Model(std::forward<Range>(r));
+    }
+
+    const T& current() const
+    {
+        return batch()[position_];
+    }
+
+    void advance()
+    {
+        if(++position_ == size_) { refill(); }
+    }
+
+    void refill()
+    {
+        clear();
+        size_ = impl_->pull(batch(), batch_size);
+        done_ = size_ == 0;
+    }
+
+    // Destroys the elements in the batch.
+    void clear()
+    {
+        for(std::size_t i = 0; i != size_; ++i) { batch()[i].~T(); }
+        size_     = 0;
+        position_ = 0;
+    }
+
+    // Destroys the range.
+    void reset()
+    {
+        if(impl_ == nullptr) { return; }
+        if(inline_) {
+            impl_->~any_range_concept();
+        }
+        else {
+            delete impl_;
+        }
+        impl_   = nullptr;
+        inline_ = false;
+    }
+
+    T* batch()
+    {
+        return reinterpret_cast<T*>(&batch_);
+    }
+
+    const T* batch() const
+    {
+        return reinterpret_cast<const T*>(&batch_);
+    }
+
+    std::aligned_storage_t<inline_size, alignof(std::max_align_t)>   storage_;
+    detail::any_range_concept<T>*                                   impl_;
+    bool                                                            inline_;
+    std::aligned_storage_t<sizeof(T) * batch_size, alignof(T)>      batch_;
+    std::size_t                                                     size_;
+    std::size_t                                                     position_;
+    bool                                                            done_;
+};
+
+} // end namespace adaptor
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+#include "range_split.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <ostream>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace adaptor
+{
+
+enum class exec_policy
+{
+    sequential,     // element by element through the pipeline's iterators
+    vectorized,     // a counted loop over a random access range
+    parallel        // pieces of the range on separate threads
+};
+
+inline const char* to_string(exec_policy policy)
+{
+    switch(policy) {
+        case exec_policy::sequential: return "sequential";
+        case exec_policy::vectorized: return "vectorized";
+        case exec_policy::parallel:   return "parallel";
+    }
+    return "unknown";
+}
+
+// What auto_exec decided, and what it based the decision on.
+struct exec_report
+{
+    exec_policy policy;
+    std::size_t threads;
+    std::size_t elements;           // positions in the range (see split_size())
+    std::size_t sampled;            // positions run to calibrate the cost
+    double      ns_per_element;     // measured over the sample, 0 if none
+};
+
+inline std::ostream& operator<<(std::ostream& os, const exec_report& report)
+{
+    os << "auto_exec: " << to_string(report.policy);
+    if(report.policy == exec_policy::parallel) {
+        os << " on " << report.threads << " threads";
+    }
+    os << " (" << report.elements << " elements";
+    if(report.sampled != 0) {
+        os << ", " << report.ns_per_element << " ns/element over "
+           << report.sampled << " sampled";
+    }
+    return os << ")";
+}
+
+namespace detail
+{
+
+template <typename Range, typename UnaryFunc>
+void run_sequential(Range&& r, UnaryFunc& func)
+{
+    for(auto&& value : r) {
+        func(value);
+    }
+}
+
+// A loop with a known trip count, which the compiler can vectorize through
+// random access stages (map(), stride(), reverse(), ...). Contiguous
+// ranges are run as a plain pointer loop.
+
+template <typename Range, typename UnaryFunc>
+void run_vectorized(Range& r, std::size_t from, std::size_t to, UnaryFunc& func, std::true_type)
+{
+    auto* first = r.data() + from;
+    auto* last  = r.data() + to;
+    for(; first != last; ++first) {
+        func(*first);
+    }
+}
+
+template <typename Range, typename UnaryFunc>
+void run_vectorized(Range& r, std::size_t from, std::size_t to, UnaryFunc& func, std::false_type)
+{
+    auto first = r.begin() + static_cast<difference_type_t<Range>>(from);
+    for(auto n = to - from; n != 0; --n, ++first) {
+        func(*first);
+    }
+}
+
+// A sample of this many positions is timed to estimate the per element
+// cost, and a thread is only worth starting for this much work.
+constexpr std::size_t   auto_exec_sample_size   = 256;
+constexpr std::uint64_t auto_exec_ns_per_thread = 200000;
+
+template <typename UnaryFunc>
+struct inner_auto_exec
+{
+    UnaryFunc     func_;
+    std::ostream* log_;
+    std::size_t   threads_;
+
+    inner_auto_exec(UnaryFunc func, std::ostream* log, std::size_t threads)
+        : func_(func),
+          log_(log),
+          threads_(threads)
+    { }
+
+    template <typename Range>
+    exec_report operator()(Range&& r)
+    {
+        auto report = run(r, std::integral_constant<bool,
+            is_splittable<Range>::value || is_random_access<Range>::value
+        >());
+        if(log_ != nullptr) { *log_ << report << '\n'; }
+        return report;
+    }
+
+private:
+
+    // Ranges that can't be cut into pieces can only be run in order.
+    template <typename Range>
+    exec_report run(Range& r, std::false_type)
+    {
+        std::size_t n = 0;
+        for(auto&& value : r) {
+            func_(value);
+            ++n;
+        }
+        return exec_report{ exec_policy::sequential, 1, n, 0, 0.0 };
+    }
+
+    template <typename Range>
+    exec_report run(Range& r, std::true_type)
+    {
+        const auto n      = piece_count(r);
+        const auto sample = std::min(n, auto_exec_sample_size);
+
+        const auto start = std::chrono::steady_clock::now();
+        run_piece(r, 0, sample, is_random_access<Range>());
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start
+        ).count();
+
+        exec_report report{ exec_policy::sequential, 1, n, sample, 0.0 };
+        report.ns_per_element = sample == 0 ? 0.0 : double(ns) / double(sample);
+
+        const auto rest      = n - sample;
+        const auto estimate  = static_cast<std::uint64_t>(report.ns_per_element * double(rest));
+        const auto threads   = std::min<std::uint64_t>(threads_, estimate / auto_exec_ns_per_thread);
+
+        if(threads > 1 && !is_order_dependent<std::remove_reference_t<Range>>::value) {
+            report.policy  = exec_policy::parallel;
+            report.threads = static_cast<std::size_t>(threads);
+            run_parallel(r, sample, n, report.threads);
+        }
+        else {
+            if(is_random_access<Range>::value) { report.policy = exec_policy::vectorized; }
+            run_piece(r, sample, n, is_random_access<Range>());
+        }
+
+        return report;
+    }
+
+    template <typename Range>
+    void run_piece(Range& r, std::size_t from, std::size_t to, std::true_type)
+    {
+        run_vectorized(r, from, to, func_, is_contiguous<Range>());
+    }
+
+    template <typename Range>
+    void run_piece(Range& r, std::size_t from, std::size_t to, std::false_type)
+    {
+        run_sequential(piece(r, from, to), func_);
+    }
+
+    // The last piece is run on the calling thread.
+    template <typename Range>
+    void run_parallel(Range& r, std::size_t from, std::size_t to, std::size_t threads)
+    {
+        const auto size = to - from;
+        std::vector<std::future<void>> workers;
+        workers.reserve(threads - 1);
+
+        for(std::size_t i = 0; i + 1 < threads; ++i) {
+            const auto first = from + size * i / threads;
+            const auto last  = from + size * (i + 1) / threads;
+            workers.push_back(std::async(std::launch::async, [this, &r, first, last]() {
+                run_piece(r, first, last, is_random_access<Range>());
+            }));
+        }
+
+        run_piece(r, from + size * (threads - 1) / threads, to, is_random_access<Range>());
+        for(auto& worker : workers) {
+            worker.get();
+        }
+    }
+};
+
+} // end namespace detail
+
+// Calls func on every element of a range, picking how to do it:
+//  - ranges that can't be cut into pieces (e.g. a generator, a std::list,
+//    or anything built on them) run in order;
+//  - otherwise the first few hundred elements are timed, and if the rest
+//    is estimated to be enough work for several threads, and nothing in the
+//    pipeline depends on element order (like unique()), the rest is split
+//    across threads. func must then be safe to call concurrently;
+//  - otherwise random access ranges (e.g. a vector through map() and
+//    stride()) are run as a counted loop the compiler can vectorize, and
+//    anything else (e.g. behind a filter()) element by element.
+//
+// Returns (and optionally logs) an exec_report describing the decision.
+template <typename UnaryFunc>
+detail::inner_auto_exec<UnaryFunc> auto_exec(
+    UnaryFunc func, std::ostream* log = nullptr,
+    std::size_t threads = std::thread::hardware_concurrency()
+)
+{
+    return detail::inner_auto_exec<UnaryFunc>(
+        func, log, std::max<std::size_t>(threads, 1)
+    );
+}
+
+template <typename Range, typename UnaryFunc>
+exec_report operator|(Range&& c, detail::inner_auto_exec<UnaryFunc> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
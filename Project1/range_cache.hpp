@@ -0,0 +1,149 @@
+#pragma once
+
+// Requires C++17 (std::pmr).
+
+#include "iterator_helpers.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+namespace adaptor
+{
+namespace detail
+{
+
+// Runs the upstream pipeline once, storing its output in memory taken from
+// a caller supplied std::pmr::memory_resource, and then acts as a
+// contiguous random access source. Iterating a cache again (or splitting
+// it) doesn't re-run anything upstream.
+//
+// The intended resource is a std::pmr::monotonic_buffer_resource over a
+// buffer owned by the caller, release()d between requests: materializing
+// then never reaches the global allocator (unless the buffer runs out).
+// Any caches using the resource must be destroyed before it is released.
+template <typename T>
+struct range_cache
+{
+public:
+
+    using iterator       = T*;
+    using const_iterator = const T*;
+    using value_type     = T;
+    using reference      = T&;
+
+    template <typename Range>
+    range_cache(Range&& r, std::pmr::memory_resource* resource)
+        : values_(resource)
+    {
+        fill(r, is_random_access<Range>());
+    }
+
+    // A copy takes its memory from the same resource as the original,
+    // rather than from the default resource as a std::pmr::vector copy
+    // would. Assigning keeps the resource of the cache assigned to.
+    range_cache(const range_cache& other)
+        : values_(other.values_, other.values_.get_allocator().resource())
+    { }
+
+    range_cache(range_cache&& other) = default;
+    range_cache& operator=(const range_cache& other) = default;
+    range_cache& operator=(range_cache&& other) = default;
+
+    std::pmr::memory_resource* resource() const
+    {
+        return values_.get_allocator().resource();
+    }
+
+    iterator begin()
+    {
+        return values_.data();
+    }
+
+    iterator end()
+    {
+        return values_.data() + values_.size();
+    }
+
+    T* data()
+    {
+        return values_.data();
+    }
+
+    std::size_t size() const
+    {
+        return values_.size();
+    }
+
+    T& operator[](std::size_t n)
+    {
+        return values_[n];
+    }
+
+    std::size_t split_size() const
+    {
+        return values_.size();
+    }
+
+    iterator_range<iterator> split_range(std::size_t from, std::size_t to)
+    {
+        return iterator_range<iterator>(data() + from, data() + to);
+    }
+
+private:
+
+    // The size of random access ranges is known up front, so they take a
+    // single allocation. Otherwise the buffer grows as usual; with a
+    // monotonic resource the smaller buffers left behind are only
+    // reclaimed when the resource is released.
+    template <typename Range>
+    void fill(Range& r, std::true_type)
+    {
+        values_.reserve(static_cast<std::size_t>(r.end() - r.begin()));
+        fill(r, std::false_type());
+    }
+
+    template <typename Range>
+    void fill(Range& r, std::false_type)
+    {
+        for(auto&& value : r) {
+            values_.push_back(value);
+        }
+    }
+
+    std::pmr::vector<T> values_;
+};
+
+struct inner_cache
+{
+    std::pmr::memory_resource* resource_;
+
+    inner_cache(std::pmr::memory_resource* resource)
+        : resource_(resource)
+    { }
+
+    template <typename Range>
+    auto operator()(Range&& r)
+    {
+        return detail::range_cache<value_type_t<Range>>(
+            std::forward<Range>(r), resource_
+        );
+    }
+};
+
+} // end namespace detail
+
+inline detail::inner_cache cache(std::pmr::memory_resource& resource)
+{
+    return detail::inner_cache(&resource);
+}
+
+template <typename Range>
+auto operator|(Range&& c, detail::inner_cache inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
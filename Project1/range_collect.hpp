@@ -0,0 +1,91 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace adaptor
+{
+namespace detail
+{
+
+// Ranges that can copy themselves into a container faster than element by
+// element (e.g. flatten(), which can copy whole inner ranges at once)
+// expose a member
+//
+//   template <typename Container> void append_to(Container& out);
+//
+// which collect() uses when it's there.
+template <typename Range, typename Container, typename = void>
+struct has_append_to
+    : std::false_type
+{ };
+
+template <typename Range, typename Container>
+struct has_append_to<
+    Range,
+    Container,
+    void_t<decltype(
+        std::declval<typename std::remove_reference<Range>::type&>()
+            .append_to(std::declval<Container&>())
+    )>
+>
+    : std::true_type
+{ };
+
+template <typename Range, typename Container>
+typename std::enable_if<has_append_to<Range, Container>::value>::type
+append_to(Range& r, Container& out)
+{
+    r.append_to(out);
+}
+
+template <typename Range, typename Container>
+typename std::enable_if<
+    !has_append_to<Range, Container>::value && is_random_access<Range>::value
+>::type
+append_to(Range& r, Container& out)
+{
+    out.insert(out.end(), r.begin(), r.end());
+}
+
+template <typename Range, typename Container>
+typename std::enable_if<
+    !has_append_to<Range, Container>::value && !is_random_access<Range>::value
+>::type
+append_to(Range& r, Container& out)
+{
+    for(auto&& value : r) {
+        out.push_back(value);
+    }
+}
+
+struct inner_collect
+{
+    template <typename Range>
+    std::vector<value_type_t<Range>> operator()(Range&& r)
+    {
+        std::vector<value_type_t<Range>> result;
+        append_to(r, result);
+        return result;
+    }
+};
+
+} // end namespace detail
+
+// Copies the elements of a range into a std::vector.
+inline detail::inner_collect collect()
+{
+    return detail::inner_collect();
+}
+
+template <typename Range>
+auto operator|(Range&& c, detail::inner_collect inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+#include "range_collect.hpp"
+#include "range_filter.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace adaptor
+{
+namespace detail
+{
+
+template <typename Range, typename Container>
+std::size_t compact(Range& r, Container& out)
+{
+    const auto before = out.size();
+    append_to(r, out);
+    return out.size() - before;
+}
+
+#if defined(__AVX2__)
+
+// For each 8 bit mask, the indices of the set lanes packed to the front,
+// which is the vpermd shuffle compacting 8 lanes by that mask.
+struct compress_permutes
+{
+    alignas(32) std::int32_t index[256][8];
+
+    compress_permutes()
+    {
+        for(int mask = 0; mask < 256; ++mask) {
+            int n = 0;
+            for(int lane = 0; lane < 8; ++lane) {
+                if(mask & (1 << lane)) { index[mask][n++] = lane; }
+            }
+            for(; n < 8; ++n) { index[mask][n] = 0; }
+        }
+    }
+};
+
+inline const compress_permutes& compress_table()
+{
+    static const compress_permutes table;
+    return table;
+}
+
+// The lanes of the vector starting at first that pred keeps, as a mask.
+template <std::size_t Lanes, typename T, typename Predicate>
+unsigned keep_mask(const T* first, Predicate& pred)
+{
+    unsigned mask = 0;
+    for(unsigned lane = 0; lane < Lanes; ++lane) {
+        mask |= static_cast<unsigned>(static_cast<bool>(pred(first[lane]))) << lane;
+    }
+    return mask;
+}
+
+// 4 byte elements are packed a whole vector at a time: the predicate
+// still runs once per element, but its results become a mask, and the
+// kept elements are written with a single compress store (AVX-512) or
+// permute and store (AVX2) instead of one store each. Writes a whole
+// vector at out + n each time, so out needs vector_slack spare elements.
+// Returns how many elements of [first, first + size) were done.
+template <typename T, typename Predicate>
+std::size_t compress_vectors(
+    const T* first, std::size_t size, T* out, std::size_t& n, Predicate& pred, std::true_type
+)
+{
+    std::size_t i = 0;
+
+#if defined(__AVX512F__)
+    for(; size - i >= 16; i += 16) {
+        const unsigned mask = keep_mask<16>(first + i, pred);
+        _mm512_mask_compressstoreu_epi32(
+            out + n, static_cast<__mmask16>(mask), _mm512_loadu_si512(first + i)
+        );
+        n += static_cast<std::size_t>(_mm_popcnt_u32(mask));
+    }
+#else
+    const auto& table = compress_table();
+    for(; size - i >= 8; i += 8) {
+        const unsigned mask = keep_mask<8>(first + i, pred);
+        const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first + i));
+        const __m256i index  = _mm256_load_si256(reinterpret_cast<const __m256i*>(table.index[mask]));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i*>(out + n), _mm256_permutevar8x32_epi32(values, index)
+        );
+        n += static_cast<std::size_t>(_mm_popcnt_u32(mask));
+    }
+#endif
+
+    return i;
+}
+
+constexpr std::size_t vector_slack = 16;
+
+#else
+
+constexpr std::size_t vector_slack = 0;
+
+#endif
+
+template <typename T, typename Predicate>
+std::size_t compress_vectors(const T*, std::size_t, T*, std::size_t&, Predicate&, std::false_type)
+{
+    return 0;
+}
+
+// Branchless stream compaction for a filter over trivial elements: every
+// element is written to a small buffer and the write position only moves
+// on by the result of the predicate, so there is no data dependent branch
+// to mispredict. Full buffers are appended to the output in one go.
+template <typename Range, typename Predicate, typename Container>
+std::size_t compact_trivial(range_filter<Range, Predicate>& f, Container& out, std::false_type)
+{
+    using value_type = value_type_t<Range>;
+
+    constexpr std::size_t buffer_size =
+        sizeof(value_type) >= 4096 ? 1 : 4096 / sizeof(value_type);
+
+    value_type buffer[buffer_size];
+    auto& pred      = f.predicate();
+    auto first      = f.base().begin();
+    auto last       = f.base().end();
+    std::size_t n   = 0;
+    std::size_t all = 0;
+
+    while(first != last) {
+        for(; first != last && n < buffer_size; ++first) {
+            const value_type value = *first;
+            buffer[n] = value;
+            n += static_cast<bool>(pred(value));
+        }
+        out.insert(out.end(), buffer, buffer + n);
+        all += n;
+        n = 0;
+    }
+
+    return all;
+}
+
+// As above, over contiguous memory, where 4 byte elements can be packed a
+// vector at a time when compiled for AVX2 or AVX-512.
+template <typename Range, typename Predicate, typename Container>
+std::size_t compact_trivial(range_filter<Range, Predicate>& f, Container& out, std::true_type)
+{
+    using value_type = value_type_t<Range>;
+    using is_simd    = std::integral_constant<bool, sizeof(value_type) == 4 && vector_slack != 0>;
+
+    constexpr std::size_t buffer_size =
+        sizeof(value_type) >= 4096 ? 1 : 4096 / sizeof(value_type);
+
+    value_type buffer[buffer_size + vector_slack];
+    auto& pred        = f.predicate();
+    auto& range       = f.base();
+    const auto* first = range.data();
+    const auto size   = static_cast<std::size_t>(range.end() - range.begin());
+    std::size_t all   = 0;
+
+    for(std::size_t done = 0; done < size; ) {
+        const auto chunk = size - done < buffer_size ? size - done : buffer_size;
+        std::size_t n = 0;
+        std::size_t i = compress_vectors(first + done, chunk, buffer, n, pred, is_simd());
+        for(; i < chunk; ++i) {
+            const value_type value = first[done + i];
+            buffer[n] = value;
+            n += static_cast<bool>(pred(value));
+        }
+        out.insert(out.end(), buffer, buffer + n);
+        all  += n;
+        done += chunk;
+    }
+
+    return all;
+}
+
+template <typename Range, typename Predicate, typename Container>
+std::size_t compact_filter(range_filter<Range, Predicate>& f, Container& out, std::true_type)
+{
+    return compact_trivial(f, out, is_contiguous<Range>());
+}
+
+template <typename Range, typename Predicate, typename Container>
+std::size_t compact_filter(range_filter<Range, Predicate>& f, Container& out, std::false_type)
+{
+    const auto before = out.size();
+    append_to(f, out);
+    return out.size() - before;
+}
+
+template <typename Range, typename Predicate, typename Container>
+std::size_t compact(range_filter<Range, Predicate>& f, Container& out)
+{
+    return compact_filter(
+        f, out, std::is_trivial<value_type_t<Range>>()
+    );
+}
+
+template <typename Container>
+struct inner_compact
+{
+    Container* out_;
+
+    inner_compact(Container& out)
+        : out_(&out)
+    { }
+
+    template <typename Range>
+    std::size_t operator()(Range&& r)
+    {
+        return compact(r, *out_);
+    }
+};
+
+} // end namespace detail
+
+// Appends the elements of a range to out (anything with insert(), e.g. a
+// std::vector), returning how many were appended. Directly after a
+// filter() of trivial elements (e.g. ints) this is done without branching
+// on the predicate; built with AVX2 or AVX-512, 4 byte elements from
+// contiguous memory are packed a vector at a time.
+template <typename Container>
+detail::inner_compact<Container> compact_into(Container& out)
+{
+    return detail::inner_compact<Container>(out);
+}
+
+template <typename Range, typename Container>
+std::size_t operator|(Range&& c, detail::inner_compact<Container> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
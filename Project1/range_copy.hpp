@@ -1,5 +1,7 @@
 #pragma once
 
+#include "iterator_helpers.hpp"
+
 #include <iterator>
 
 namespace adaptor
@@ -21,26 +23,45 @@ public:
     using value_type = typename range_type::value_type;
 
     range_slice(Range&& c, std::size_t from, std::size_t to)
-        : begin_(c.begin() + from),
-          end_(c.begin() + to)
+        : range_(std::forward<Range>(c)),
+          from_(from),
+          to_(to)
     { }
 
     ~range_slice() = default;
 
+    range_slice(const range_slice& other) = default;
+    range_slice(range_slice&& other) = default;
+
     iterator begin()
     {
-        return begin_;
+        return range_.begin() + from_;
     }
 
     iterator end()
     {
-        return end_;
+        return range_.begin() + to_;
+    }
+
+    // Splitting: a slice is already random access, so a sub-range is just
+    // a narrower slice of the same underlying range.
+
+    std::size_t split_size()
+    {
+        return to_ - from_;
+    }
+
+    iterator_range<iterator> split_range(std::size_t from, std::size_t to)
+    {
+        auto first = begin();
+        return iterator_range<iterator>(first + from, first + to);
     }
 
 private:
     
-    iterator begin_;
-    iterator end_;
+    stored_range_t<Range> range_;
+    std::size_t           from_;
+    std::size_t           to_;
 };
 
 } // end namespace detail
@@ -58,7 +79,7 @@ auto slice(std::size_t from, std::size_t to)
 template <typename Range>
 detail::range_slice<Range> slice(Range&& c, std::size_t from, std::size_t to)
 {
-    using iterator_type = typename Range::iterator;
+    using iterator_type = typename std::remove_reference_t<Range>::iterator;
 
     static_assert(
         std::is_same<
@@ -3,7 +3,9 @@
 #include "iterator_helpers.hpp"
 
 #include <iterator>
+#include <memory>
 #include <type_traits>
+#include <utility>
 
 namespace adaptor
 {
@@ -17,7 +19,7 @@ struct range_filter;
 template <typename Range, typename Predicate>
 struct range_filter_iterator 
     : public std::iterator<
-        std::forward_iterator_tag,
+        forward_category_t<Range>,
         value_type_t<Range>,
         difference_type_t<Range>
       >
@@ -31,23 +33,27 @@ private:
 
 public:
 
-    using reference = typename std::iterator_traits<base_iterator>::reference;
+    using reference = decltype(*std::declval<base_iterator&>());
 
-    range_filter_iterator(range_filter_type& r, base_iterator where)
-        : parent_(r),
-          current_(where)
-    { }
+    // An iterator always rests on an element satisfying the predicate (or
+    // on end), so it is moved forward to the first one on construction.
+    range_filter_iterator(range_filter_type& r, base_iterator where, base_iterator end)
+        : parent_(std::addressof(r)),
+          current_(where),
+          end_(end)
+    { 
+        while (current_ != end_ && !parent_->func_(*current_)) { ++current_; }
+    }
 
     reference operator*() 
     {
-        while (!parent_.func_(*current_)) { ++current_; }
         return *current_;
     }
 
     self_type& operator++()
     {
         ++current_;
-        while (current_ != parent_.range_.end() && !parent_.func_(*current_)) { 
+        while (current_ != end_ && !parent_->func_(*current_)) { 
             ++current_; 
         }
         return *this;
@@ -56,7 +62,7 @@ public:
     self_type& operator--()
     {
         --current_;
-        while (current_ != parent_.range_.begin() && !parent_.func_(*current_)) { 
+        while (current_ != parent_->range_.begin() && !parent_->func_(*current_)) { 
             --current_; 
         }
         return *this;
@@ -64,14 +70,14 @@ public:
 
     bool equals(self_type other) const
     {
-        return std::addressof(parent_) == std::addressof(other.parent_) &&
-            current_ == other.current_;
+        return parent_ == other.parent_ && current_ == other.current_;
     }
 
 private:
 
-    range_filter_type& parent_;
+    range_filter_type* parent_;
     base_iterator      current_;
+    base_iterator      end_;
 };
 
 template <typename Range, typename Predicate>
@@ -106,23 +112,62 @@ public:
 
     range_filter(Range&& r, Predicate func)
         : range_(std::forward<Range>(r)),
-          func_(func)
+          func_(std::move(func))
     { }
 
     iterator begin()
     {
-        return iterator(*this, range_.begin());
+        return iterator(*this, range_.begin(), range_.end());
     }
 
     iterator end()
     {
-        return iterator(*this, range_.end());
+        return iterator(*this, range_.end(), range_.end());
+    }
+
+    // The underlying range and the predicate, for terminals that can do
+    // better than walking the filter's iterators (see compact_into).
+
+    std::remove_reference_t<Range>& base()
+    {
+        return range_;
+    }
+
+    Predicate& predicate()
+    {
+        return func_;
+    }
+
+    // Splitting: how many elements pass the predicate isn't known up front,
+    // so a filter is split on positions in the underlying range. Each piece
+    // only looks at its own part of the underlying range. Only available
+    // when the underlying range can be cut (see is_position_splittable).
+
+    template <typename R = Range>
+    typename std::enable_if<is_position_splittable<R>::value, std::size_t>::type
+    split_size()
+    {
+        return static_cast<std::size_t>(
+            std::distance(range_.begin(), range_.end())
+        );
+    }
+
+    template <typename R = Range>
+    typename std::enable_if<is_position_splittable<R>::value, iterator_range<iterator>>::type
+    split_range(std::size_t from, std::size_t to)
+    {
+        using difference_type = difference_type_t<Range>;
+        auto first = std::next(range_.begin(), static_cast<difference_type>(from));
+        auto last  = std::next(first, static_cast<difference_type>(to - from));
+        return iterator_range<iterator>(
+            iterator(*this, first, last), iterator(*this, last, last)
+        );
     }
 
 private:
 
-    Range&&    range_;
-    Predicate  func_;
+    stored_range_t<Range> range_;
+    Predicate             func_;
 };
 
 template <typename Predicate>
@@ -131,16 +176,25 @@ struct inner_filter
     Predicate p_;
 
     inner_filter(Predicate p)
-        : p_(p)
+        : p_(std::move(p))
     { }
 
     template <typename Range>
-    auto operator()(Range&& r)
+    auto operator()(Range&& r) &
     {
         return detail::range_filter<Range, Predicate>(
             std::forward<Range>(r), p_
         );
     }
+
+    // Used by operator|, so move-only callables can be piped in directly.
+    template <typename Range>
+    auto operator()(Range&& r) &&
+    {
+        return detail::range_filter<Range, Predicate>(
+            std::forward<Range>(r), std::move(p_)
+        );
+    }
 };
 
 } // end namespace detail
@@ -164,13 +218,13 @@ auto range_transform(UnaryFunc f)
 template <typename Predicate>
 detail::inner_filter<Predicate> filter(Predicate f)
 {
-    return detail::inner_filter<Predicate>(f);
+    return detail::inner_filter<Predicate>(std::move(f));
 }
 
 template <typename Range, typename Predicate>
 auto operator|(Range&& c, detail::inner_filter<Predicate> inner)
 {
-    return inner(std::forward<Range>(c));
+    return std::move(inner)(std::forward<Range>(c));
 }
 
 } // end namespace adaptor
@@ -0,0 +1,228 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+#include "range_split.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <future>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace adaptor
+{
+
+// What find_first() found, if anything. value is default constructed when
+// nothing was found.
+template <typename T>
+struct find_result
+{
+    bool found;
+    T    value;
+
+    explicit operator bool() const
+    {
+        return found;
+    }
+};
+
+namespace detail
+{
+
+// All of these stop pulling elements through the pipeline as soon as the
+// answer is known.
+
+template <typename Predicate>
+struct inner_find_first
+{
+    Predicate p_;
+
+    inner_find_first(Predicate p)
+        : p_(std::move(p))
+    { }
+
+    template <typename Range>
+    find_result<value_type_t<Range>> operator()(Range&& r)
+    {
+        for(auto&& value : r) {
+            if(p_(value)) { return { true, value }; }
+        }
+        return { false, value_type_t<Range>() };
+    }
+};
+
+template <typename Predicate>
+struct inner_any_of
+{
+    Predicate p_;
+
+    inner_any_of(Predicate p)
+        : p_(std::move(p))
+    { }
+
+    template <typename Range>
+    bool operator()(Range&& r)
+    {
+        for(auto&& value : r) {
+            if(p_(value)) { return true; }
+        }
+        return false;
+    }
+};
+
+template <typename Predicate>
+struct inner_all_of
+{
+    Predicate p_;
+
+    inner_all_of(Predicate p)
+        : p_(std::move(p))
+    { }
+
+    template <typename Range>
+    bool operator()(Range&& r)
+    {
+        for(auto&& value : r) {
+            if(!p_(value)) { return false; }
+        }
+        return true;
+    }
+};
+
+//================================================================================
+
+// The range is cut into more pieces than there are threads, and the
+// threads claim pieces in order. A match lowers best to the index of its
+// piece; from then on no piece after it is started, and pieces after it
+// that are underway stop at their next element. Pieces before it carry on,
+// since they can still hold an earlier match.
+template <typename Predicate>
+struct inner_find_first_parallel
+{
+    Predicate   p_;
+    std::size_t threads_;
+
+    static constexpr std::size_t pieces_per_thread = 8;
+
+    inner_find_first_parallel(Predicate p, std::size_t threads)
+        : p_(std::move(p)),
+          threads_(threads)
+    { }
+
+    template <typename Range>
+    find_result<value_type_t<Range>> operator()(Range&& r)
+    {
+        static_assert(
+            is_splittable<Range>::value || is_random_access<Range>::value,
+            "Range must be splittable (see range_split.hpp) or random access for find_first_parallel!"
+        );
+
+        using result_type = find_result<value_type_t<Range>>;
+
+        const piece_cutter<std::remove_reference_t<Range>> cut(r);
+
+        const auto size   = cut.size();
+        const auto pieces = std::max<std::size_t>(
+            1, std::min(size, threads_ * pieces_per_thread)
+        );
+
+        std::vector<result_type> results(pieces, result_type{ false, value_type_t<Range>() });
+        std::atomic<std::size_t> next(0);
+        std::atomic<std::size_t> best(pieces);
+
+        auto work = [&]() {
+            for(;;) {
+                const auto i = next.fetch_add(1);
+                if(i >= pieces || i > best.load()) { return; }
+
+                for(auto&& value : cut(size * i / pieces, size * (i + 1) / pieces)) {
+                    if(best.load(std::memory_order_relaxed) < i) { break; }
+                    if(p_(value)) {
+                        results[i] = { true, value };
+                        auto current = best.load();
+                        while(i < current && !best.compare_exchange_weak(current, i)) { }
+                        break;
+                    }
+                }
+            }
+        };
+
+        std::vector<std::future<void>> workers;
+        workers.reserve(threads_ - 1);
+        for(std::size_t i = 1; i < threads_; ++i) {
+            workers.push_back(std::async(std::launch::async, work));
+        }
+
+        work();
+        for(auto& worker : workers) {
+            worker.get();
+        }
+
+        const auto found = best.load();
+        return found < pieces ? results[found] : results.front();
+    }
+};
+
+} // end namespace detail
+
+// The first element satisfying p, as a find_result.
+template <typename Predicate>
+detail::inner_find_first<Predicate> find_first(Predicate p)
+{
+    return detail::inner_find_first<Predicate>(std::move(p));
+}
+
+template <typename Predicate>
+detail::inner_any_of<Predicate> any_of(Predicate p)
+{
+    return detail::inner_any_of<Predicate>(std::move(p));
+}
+
+template <typename Predicate>
+detail::inner_all_of<Predicate> all_of(Predicate p)
+{
+    return detail::inner_all_of<Predicate>(std::move(p));
+}
+
+// As find_first, but pieces of the range (see range_split.hpp) are searched
+// on separate threads, and work after a match is cancelled. The result is
+// still the first match in order. p and the functions of the stages in the
+// pipeline are shared between the threads.
+template <typename Predicate>
+detail::inner_find_first_parallel<Predicate> find_first_parallel(
+    Predicate p, std::size_t threads = std::thread::hardware_concurrency()
+)
+{
+    return detail::inner_find_first_parallel<Predicate>(
+        std::move(p), std::max<std::size_t>(threads, 1)
+    );
+}
+
+template <typename Range, typename Predicate>
+auto operator|(Range&& c, detail::inner_find_first<Predicate> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+template <typename Range, typename Predicate>
+bool operator|(Range&& c, detail::inner_any_of<Predicate> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+template <typename Range, typename Predicate>
+bool operator|(Range&& c, detail::inner_all_of<Predicate> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+template <typename Range, typename Predicate>
+auto operator|(Range&& c, detail::inner_find_first_parallel<Predicate> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
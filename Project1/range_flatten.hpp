@@ -0,0 +1,231 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace adaptor
+{
+namespace detail
+{
+
+template <typename Range, typename UnaryFunc>
+struct range_flat_map;
+
+template <typename Range, typename UnaryFunc>
+struct range_flat_map_iterator
+    : public std::iterator<
+        std::forward_iterator_tag,
+        typename range_flat_map<Range, UnaryFunc>::value_type
+      >
+{
+private:
+
+    using range_type          = typename std::remove_reference<Range>::type;
+    using self_type           = range_flat_map_iterator<Range, UnaryFunc>;
+    using range_flat_map_type = range_flat_map<Range, UnaryFunc>;
+    using outer_iterator      = typename range_type::iterator;
+    using inner_iterator      = typename range_flat_map_type::inner_iterator;
+
+public:
+
+    using reference = typename std::iterator_traits<inner_iterator>::reference;
+
+    range_flat_map_iterator(range_flat_map_type& r, outer_iterator where, outer_iterator end)
+        : parent_(std::addressof(r)),
+          outer_(where),
+          outer_end_(end),
+          inner_(),
+          inner_end_()
+    {
+        if(outer_ != outer_end_) {
+            auto& inner = parent_->func_(*outer_);
+            inner_     = inner.begin();
+            inner_end_ = inner.end();
+            skip_empty();
+        }
+    }
+
+    reference operator*()
+    {
+        return *inner_;
+    }
+
+    self_type& operator++()
+    {
+        ++inner_;
+        skip_empty();
+        return *this;
+    }
+
+    self_type operator++(int)
+    {
+        self_type ret(*this);
+        ++(*this);
+        return ret;
+    }
+
+    bool equals(self_type other) const
+    {
+        return parent_ == other.parent_ && outer_ == other.outer_ &&
+            (outer_ == outer_end_ || inner_ == other.inner_);
+    }
+
+private:
+
+    // Moves on to the next non-empty inner range once the current one
+    // is used up.
+    void skip_empty()
+    {
+        while(inner_ == inner_end_) {
+            ++outer_;
+            if(outer_ == outer_end_) { return; }
+            auto& inner = parent_->func_(*outer_);
+            inner_     = inner.begin();
+            inner_end_ = inner.end();
+        }
+    }
+
+    range_flat_map_type* parent_;
+    outer_iterator       outer_;
+    outer_iterator       outer_end_;
+    inner_iterator       inner_;
+    inner_iterator       inner_end_;
+};
+
+template <typename Range, typename UnaryFunc>
+bool operator==(
+    range_flat_map_iterator<Range, UnaryFunc> r1, range_flat_map_iterator<Range, UnaryFunc> r2
+)
+{
+    return r1.equals(r2);
+}
+
+template <typename Range, typename UnaryFunc>
+bool operator!=(
+    range_flat_map_iterator<Range, UnaryFunc> r1, range_flat_map_iterator<Range, UnaryFunc> r2
+)
+{
+    return !operator==(r1, r2);
+}
+
+//================================================================================
+
+// Iterates over every element of every inner range, where the inner range
+// for each element of the outer range is func(element). func must return
+// an lvalue reference to a range living at least as long as the outer
+// range (usually a member of the element), since the inner iterators are
+// kept across calls.
+template <typename Range, typename UnaryFunc>
+struct range_flat_map
+{
+    friend struct range_flat_map_iterator<Range, UnaryFunc>;
+
+    using range_type      = typename std::remove_reference<Range>::type;
+    using outer_iterator  = typename range_type::iterator;
+    using outer_reference = decltype(*std::declval<outer_iterator&>());
+    using inner_result    = std::result_of_t<UnaryFunc(outer_reference)>;
+    using inner_iterator  = decltype(std::declval<inner_result>().begin());
+
+    static_assert(
+        std::is_lvalue_reference<inner_result>::value,
+        "flat_map function must return a reference to a range!"
+    );
+
+public:
+
+    using iterator   = range_flat_map_iterator<Range, UnaryFunc>;
+    using value_type = typename std::iterator_traits<inner_iterator>::value_type;
+    using reference  = typename std::iterator_traits<inner_iterator>::reference;
+
+    range_flat_map(Range&& r, UnaryFunc func)
+        : range_(std::forward<Range>(r)),
+          func_(func)
+    { }
+
+    iterator begin()
+    {
+        return iterator(*this, range_.begin(), range_.end());
+    }
+
+    iterator end()
+    {
+        return iterator(*this, range_.end(), range_.end());
+    }
+
+    // Used by collect(): each inner range is inserted as a whole, which is a
+    // single memmove for contiguous inner ranges of trivially copyable types.
+    template <typename Container>
+    void append_to(Container& out)
+    {
+        for(auto&& outer : range_) {
+            auto& inner = func_(outer);
+            out.insert(out.end(), inner.begin(), inner.end());
+        }
+    }
+
+private:
+
+    stored_range_t<Range> range_;
+    UnaryFunc             func_;
+};
+
+struct flatten_identity
+{
+    template <typename T>
+    T& operator()(T& inner) const
+    {
+        return inner;
+    }
+};
+
+template <typename UnaryFunc>
+struct inner_flat_map
+{
+    UnaryFunc f_;
+
+    inner_flat_map(UnaryFunc f)
+        : f_(f)
+    { }
+
+    template <typename Range>
+    auto operator()(Range&& r)
+    {
+        static_assert(
+            std::is_lvalue_reference<
+                decltype(*std::declval<typename std::remove_reference_t<Range>::iterator&>())
+            >::value,
+            "flat_map requires an outer range whose elements are references!"
+        );
+
+        return detail::range_flat_map<Range, UnaryFunc>(
+            std::forward<Range>(r), f_
+        );
+    }
+};
+
+} // end namespace detail
+
+template <typename UnaryFunc>
+detail::inner_flat_map<UnaryFunc> flat_map(UnaryFunc f)
+{
+    return detail::inner_flat_map<UnaryFunc>(f);
+}
+
+inline detail::inner_flat_map<detail::flatten_identity> flatten()
+{
+    return detail::inner_flat_map<detail::flatten_identity>(
+        detail::flatten_identity()
+    );
+}
+
+template <typename Range, typename UnaryFunc>
+auto operator|(Range&& c, detail::inner_flat_map<UnaryFunc> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
@@ -0,0 +1,394 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace adaptor
+{
+namespace detail
+{
+
+template <typename Range, typename KeyFunc>
+struct range_group_by;
+
+template <typename Range, typename KeyFunc>
+struct range_group_by_iterator
+    : public std::iterator<
+        std::forward_iterator_tag,
+        typename range_group_by<Range, KeyFunc>::value_type
+      >
+{
+private:
+
+    using range_type          = typename std::remove_reference<Range>::type;
+    using self_type           = range_group_by_iterator<Range, KeyFunc>;
+    using range_group_by_type = range_group_by<Range, KeyFunc>;
+    using base_iterator       = typename range_type::iterator;
+
+public:
+
+    using value_type = typename range_group_by_type::value_type;
+
+    range_group_by_iterator(range_group_by_type& r, base_iterator where, base_iterator end)
+        : parent_(std::addressof(r)),
+          current_(where),
+          next_(where),
+          end_(end)
+    {
+        find_next();
+    }
+
+    value_type operator*()
+    {
+        return value_type(
+            parent_->func_(*current_),
+            iterator_range<base_iterator>(current_, next_)
+        );
+    }
+
+    self_type& operator++()
+    {
+        current_ = next_;
+        find_next();
+        return *this;
+    }
+
+    self_type operator++(int)
+    {
+        self_type ret(*this);
+        ++(*this);
+        return ret;
+    }
+
+    bool equals(self_type other) const
+    {
+        return parent_ == other.parent_ && current_ == other.current_;
+    }
+
+private:
+
+    void find_next()
+    {
+        if(current_ == end_) { return; }
+        const auto key = parent_->func_(*current_);
+        ++next_;
+        while(next_ != end_ && parent_->func_(*next_) == key) { ++next_; }
+    }
+
+    range_group_by_type* parent_;
+    base_iterator        current_;
+    base_iterator        next_;
+    base_iterator        end_;
+};
+
+template <typename Range, typename KeyFunc>
+bool operator==(
+    range_group_by_iterator<Range, KeyFunc> r1, range_group_by_iterator<Range, KeyFunc> r2
+)
+{
+    return r1.equals(r2);
+}
+
+template <typename Range, typename KeyFunc>
+bool operator!=(
+    range_group_by_iterator<Range, KeyFunc> r1, range_group_by_iterator<Range, KeyFunc> r2
+)
+{
+    return !operator==(r1, r2);
+}
+
+//================================================================================
+
+// Groups runs of consecutive elements with equal keys, yielding a
+// (key, sub-range) pair for each run. The sub-ranges are views into the
+// underlying range, nothing is copied. With an identity key function this
+// walks the same runs unique() does.
+template <typename Range, typename KeyFunc>
+struct range_group_by
+{
+    friend struct range_group_by_iterator<Range, KeyFunc>;
+
+    using range_type    = typename std::remove_reference<Range>::type;
+    using base_iterator = typename range_type::iterator;
+    using base_ref      = typename std::iterator_traits<base_iterator>::reference;
+
+public:
+
+    using key_type   = std::decay_t<std::result_of_t<KeyFunc(base_ref)>>;
+    using group_type = iterator_range<base_iterator>;
+    using iterator   = range_group_by_iterator<Range, KeyFunc>;
+    using value_type = std::pair<key_type, group_type>;
+    using reference  = value_type&;
+
+    range_group_by(Range&& r, KeyFunc func)
+        : range_(std::forward<Range>(r)),
+          func_(std::move(func))
+    { }
+
+    iterator begin()
+    {
+        return iterator(*this, range_.begin(), range_.end());
+    }
+
+    iterator end()
+    {
+        return iterator(*this, range_.end(), range_.end());
+    }
+
+private:
+
+    stored_range_t<Range> range_;
+    KeyFunc               func_;
+};
+
+//================================================================================
+
+template <typename Range, typename KeyFunc, typename AggFunc, typename T>
+struct range_aggregate_by;
+
+template <typename Range, typename KeyFunc, typename AggFunc, typename T>
+struct range_aggregate_by_iterator
+    : public std::iterator<
+        std::forward_iterator_tag,
+        typename range_aggregate_by<Range, KeyFunc, AggFunc, T>::value_type
+      >
+{
+private:
+
+    using range_type              = typename std::remove_reference<Range>::type;
+    using self_type               = range_aggregate_by_iterator<Range, KeyFunc, AggFunc, T>;
+    using range_aggregate_by_type = range_aggregate_by<Range, KeyFunc, AggFunc, T>;
+    using base_iterator           = typename range_type::iterator;
+
+public:
+
+    using value_type = typename range_aggregate_by_type::value_type;
+    using reference  = const value_type&;
+
+    range_aggregate_by_iterator(
+        range_aggregate_by_type& r, base_iterator where, base_iterator end
+    )
+        : parent_(std::addressof(r)),
+          current_(where),
+          next_(where),
+          end_(end)
+    {
+        fold_next();
+    }
+
+    reference operator*() const
+    {
+        return value_;
+    }
+
+    self_type& operator++()
+    {
+        current_ = next_;
+        fold_next();
+        return *this;
+    }
+
+    self_type operator++(int)
+    {
+        self_type ret(*this);
+        ++(*this);
+        return ret;
+    }
+
+    bool equals(const self_type& other) const
+    {
+        return parent_ == other.parent_ && current_ == other.current_;
+    }
+
+private:
+
+    // Finds the end of the group starting at current_ and folds it in the
+    // same pass, computing each key only once.
+    void fold_next()
+    {
+        if(current_ == end_) { return; }
+        value_.first  = parent_->key_(*current_);
+        value_.second = parent_->agg_(parent_->init_, *next_);
+        ++next_;
+        while(next_ != end_ && parent_->key_(*next_) == value_.first) {
+            value_.second = parent_->agg_(std::move(value_.second), *next_);
+            ++next_;
+        }
+    }
+
+    range_aggregate_by_type* parent_;
+    base_iterator            current_;
+    base_iterator            next_;
+    base_iterator            end_;
+    value_type               value_;
+};
+
+template <typename Range, typename KeyFunc, typename AggFunc, typename T>
+bool operator==(
+    const range_aggregate_by_iterator<Range, KeyFunc, AggFunc, T>& r1,
+    const range_aggregate_by_iterator<Range, KeyFunc, AggFunc, T>& r2
+)
+{
+    return r1.equals(r2);
+}
+
+template <typename Range, typename KeyFunc, typename AggFunc, typename T>
+bool operator!=(
+    const range_aggregate_by_iterator<Range, KeyFunc, AggFunc, T>& r1,
+    const range_aggregate_by_iterator<Range, KeyFunc, AggFunc, T>& r2
+)
+{
+    return !operator==(r1, r2);
+}
+
+// Folds each run of consecutive elements with equal keys, yielding a
+// (key, agg(...agg(agg(init, e0), e1)..., en)) pair for each run. Both the
+// key and the accumulated type must be default constructible.
+template <typename Range, typename KeyFunc, typename AggFunc, typename T>
+struct range_aggregate_by
+{
+    friend struct range_aggregate_by_iterator<Range, KeyFunc, AggFunc, T>;
+
+    using range_type    = typename std::remove_reference<Range>::type;
+    using base_iterator = typename range_type::iterator;
+    using base_ref      = typename std::iterator_traits<base_iterator>::reference;
+
+public:
+
+    using key_type   = std::decay_t<std::result_of_t<KeyFunc(base_ref)>>;
+    using iterator   = range_aggregate_by_iterator<Range, KeyFunc, AggFunc, T>;
+    using value_type = std::pair<key_type, T>;
+    using reference  = const value_type&;
+
+    range_aggregate_by(Range&& r, KeyFunc key, AggFunc agg, T init)
+        : range_(std::forward<Range>(r)),
+          key_(std::move(key)),
+          agg_(std::move(agg)),
+          init_(std::move(init))
+    { }
+
+    iterator begin()
+    {
+        return iterator(*this, range_.begin(), range_.end());
+    }
+
+    iterator end()
+    {
+        return iterator(*this, range_.end(), range_.end());
+    }
+
+private:
+
+    stored_range_t<Range> range_;
+    KeyFunc               key_;
+    AggFunc               agg_;
+    T                     init_;
+};
+
+template <typename Range, typename KeyFunc>
+struct is_order_dependent<range_group_by<Range, KeyFunc>>
+    : std::true_type
+{ };
+
+template <typename Range, typename KeyFunc, typename AggFunc, typename T>
+struct is_order_dependent<range_aggregate_by<Range, KeyFunc, AggFunc, T>>
+    : std::true_type
+{ };
+
+//================================================================================
+
+template <typename KeyFunc>
+struct inner_group_by
+{
+    KeyFunc f_;
+
+    inner_group_by(KeyFunc f)
+        : f_(std::move(f))
+    { }
+
+    template <typename Range>
+    auto operator()(Range&& r) &
+    {
+        return detail::range_group_by<Range, KeyFunc>(
+            std::forward<Range>(r), f_
+        );
+    }
+
+    // Used by operator|, so move-only callables can be piped in directly.
+    template <typename Range>
+    auto operator()(Range&& r) &&
+    {
+        return detail::range_group_by<Range, KeyFunc>(
+            std::forward<Range>(r), std::move(f_)
+        );
+    }
+};
+
+template <typename KeyFunc, typename AggFunc, typename T>
+struct inner_aggregate_by
+{
+    KeyFunc key_;
+    AggFunc agg_;
+    T       init_;
+
+    inner_aggregate_by(KeyFunc key, AggFunc agg, T init)
+        : key_(std::move(key)),
+          agg_(std::move(agg)),
+          init_(std::move(init))
+    { }
+
+    template <typename Range>
+    auto operator()(Range&& r) &
+    {
+        return detail::range_aggregate_by<Range, KeyFunc, AggFunc, T>(
+            std::forward<Range>(r), key_, agg_, init_
+        );
+    }
+
+    // Used by operator|, so move-only callables can be piped in directly.
+    template <typename Range>
+    auto operator()(Range&& r) &&
+    {
+        return detail::range_aggregate_by<Range, KeyFunc, AggFunc, T>(
+            std::forward<Range>(r), std::move(key_), std::move(agg_), std::move(init_)
+        );
+    }
+};
+
+} // end namespace detail
+
+template <typename KeyFunc>
+detail::inner_group_by<KeyFunc> group_by(KeyFunc key_fn)
+{
+    return detail::inner_group_by<KeyFunc>(std::move(key_fn));
+}
+
+// agg is called as agg(accumulated, element) and returns the new
+// accumulated value; each group starts from a copy of init. The key and
+// aggregate functions may be move-only.
+template <typename KeyFunc, typename AggFunc, typename T>
+detail::inner_aggregate_by<KeyFunc, AggFunc, T>
+aggregate_by(KeyFunc key_fn, AggFunc agg, T init)
+{
+    return detail::inner_aggregate_by<KeyFunc, AggFunc, T>(
+        std::move(key_fn), std::move(agg), std::move(init)
+    );
+}
+
+template <typename Range, typename KeyFunc>
+auto operator|(Range&& c, detail::inner_group_by<KeyFunc> inner)
+{
+    return std::move(inner)(std::forward<Range>(c));
+}
+
+template <typename Range, typename KeyFunc, typename AggFunc, typename T>
+auto operator|(Range&& c, detail::inner_aggregate_by<KeyFunc, AggFunc, T> inner)
+{
+    return std::move(inner)(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
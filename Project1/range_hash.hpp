@@ -0,0 +1,304 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+namespace adaptor
+{
+
+// Hashers for hash_into(). A hasher is default constructible and has
+//
+//   void update(const unsigned char* data, std::size_t size);
+//   result_type digest() const;
+//
+// update() is called with the bytes of consecutive elements, in batches
+// whose sizes don't affect the digest.
+
+// XXH64 with seed 0: four independent lanes each take every fourth 8 byte
+// word of a 32 byte stripe, so the multiplications of different lanes can
+// be in flight at the same time, and the lanes are combined in digest().
+// Words are read in native byte order, so digests match the reference
+// implementation on little endian machines.
+struct xxhash64
+{
+    using result_type = std::uint64_t;
+
+    xxhash64()
+        : lanes_{ prime1 + prime2, prime2, 0, 0 - prime1 },
+          length_(0),
+          buffered_(0)
+    { }
+
+    void update(const unsigned char* data, std::size_t size)
+    {
+        length_ += size;
+
+        if(buffered_ != 0) {
+            const auto n = std::min<std::size_t>(size, 32 - buffered_);
+            std::memcpy(buffer_ + buffered_, data, n);
+            buffered_ += n;
+            data      += n;
+            size      -= n;
+            if(buffered_ < 32) { return; }
+            stripe(buffer_);
+            buffered_ = 0;
+        }
+
+        for(; size >= 32; data += 32, size -= 32) {
+            stripe(data);
+        }
+
+        std::memcpy(buffer_, data, size);
+        buffered_ = size;
+    }
+
+    result_type digest() const
+    {
+        std::uint64_t h;
+        if(length_ >= 32) {
+            h = rotl(lanes_[0], 1) + rotl(lanes_[1], 7) + rotl(lanes_[2], 12) + rotl(lanes_[3], 18);
+            for(auto lane : lanes_) {
+                h = (h ^ round(0, lane)) * prime1 + prime4;
+            }
+        }
+        else {
+            h = prime5;
+        }
+        h += length_;
+
+        const unsigned char* p   = buffer_;
+        const unsigned char* end = buffer_ + buffered_;
+        for(; end - p >= 8; p += 8) {
+            h = rotl(h ^ round(0, read<std::uint64_t>(p)), 27) * prime1 + prime4;
+        }
+        if(end - p >= 4) {
+            h = rotl(h ^ (read<std::uint32_t>(p) * prime1), 23) * prime2 + prime3;
+            p += 4;
+        }
+        for(; p != end; ++p) {
+            h = rotl(h ^ (*p * prime5), 11) * prime1;
+        }
+
+        h ^= h >> 33;
+        h *= prime2;
+        h ^= h >> 29;
+        h *= prime3;
+        h ^= h >> 32;
+        return h;
+    }
+
+private:
+
+    static constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+    static constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+    static constexpr std::uint64_t prime3 = 0x165667B19E3779F9ULL;
+    static constexpr std::uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+    static constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+
+    template <typename T>
+    static T read(const unsigned char* p)
+    {
+        T value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    static std::uint64_t rotl(std::uint64_t x, int r)
+    {
+        return (x << r) | (x >> (64 - r));
+    }
+
+    static std::uint64_t round(std::uint64_t lane, std::uint64_t input)
+    {
+        return rotl(lane + input * prime2, 31) * prime1;
+    }
+
+    void stripe(const unsigned char* p)
+    {
+        lanes_[0] = round(lanes_[0], read<std::uint64_t>(p));
+        lanes_[1] = round(lanes_[1], read<std::uint64_t>(p + 8));
+        lanes_[2] = round(lanes_[2], read<std::uint64_t>(p + 16));
+        lanes_[3] = round(lanes_[3], read<std::uint64_t>(p + 24));
+    }
+
+    std::uint64_t lanes_[4];
+    std::uint64_t length_;
+    unsigned char buffer_[32];
+    std::size_t   buffered_;
+};
+
+// CRC-32C (Castagnoli), as used by iSCSI, ext4 and others. Uses the SSE4.2
+// crc32 instruction when compiled for it, 8 bytes at a time, and lookup
+// tables otherwise.
+struct crc32c_hasher
+{
+    using result_type = std::uint32_t;
+
+    crc32c_hasher()
+        : crc_(0xFFFFFFFFu)
+    { }
+
+    void update(const unsigned char* data, std::size_t size)
+    {
+        const unsigned char* end = data + size;
+#if defined(__SSE4_2__) && (defined(__x86_64__) || defined(_M_X64))
+        std::uint64_t crc = crc_;
+        for(; end - data >= 8; data += 8) {
+            std::uint64_t word;
+            std::memcpy(&word, data, sizeof(word));
+            crc = _mm_crc32_u64(crc, word);
+        }
+        crc_ = static_cast<std::uint32_t>(crc);
+#endif
+#if defined(__SSE4_2__)
+        for(; data != end; ++data) {
+            crc_ = _mm_crc32_u8(crc_, *data);
+        }
+#else
+        // Slicing by 8: one lookup in each of eight tables per 8 bytes.
+        const auto& t = table().entries;
+        for(; end - data >= 8; data += 8) {
+            const std::uint32_t lo = crc_ ^ (std::uint32_t(data[0]) | std::uint32_t(data[1]) << 8
+                                          | std::uint32_t(data[2]) << 16 | std::uint32_t(data[3]) << 24);
+            crc_ = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+                 ^ t[3][data[4]] ^ t[2][data[5]] ^ t[1][data[6]] ^ t[0][data[7]];
+        }
+        for(; data != end; ++data) {
+            crc_ = t[0][(crc_ ^ *data) & 0xFF] ^ (crc_ >> 8);
+        }
+#endif
+    }
+
+    result_type digest() const
+    {
+        return crc_ ^ 0xFFFFFFFFu;
+    }
+
+private:
+
+    // entries[0] is the CRC of each byte value; entries[k] is that CRC
+    // pushed through k more zero bytes.
+    struct crc_table
+    {
+        std::uint32_t entries[8][256];
+
+        constexpr crc_table()
+            : entries()
+        {
+            for(std::uint32_t i = 0; i < 256; ++i) {
+                std::uint32_t crc = i;
+                for(int bit = 0; bit < 8; ++bit) {
+                    crc = (crc >> 1) ^ (0x82F63B78u & (0u - (crc & 1u)));
+                }
+                entries[0][i] = crc;
+            }
+            for(std::size_t k = 1; k < 8; ++k) {
+                for(std::size_t i = 0; i < 256; ++i) {
+                    const auto crc = entries[k - 1][i];
+                    entries[k][i] = (crc >> 8) ^ entries[0][crc & 0xFF];
+                }
+            }
+        }
+    };
+
+    static const crc_table& table()
+    {
+        static constexpr crc_table t{};
+        return t;
+    }
+
+    std::uint32_t crc_;
+};
+
+namespace detail
+{
+
+template <typename Hasher>
+struct inner_hash_into
+{
+    // Contiguous ranges are hashed in place; anything else is gathered into
+    // a buffer of this many bytes at a time.
+    static constexpr std::size_t buffer_bytes = 4096;
+
+    template <typename Range>
+    typename Hasher::result_type operator()(Range&& r)
+    {
+        using value_type = value_type_t<Range>;
+
+        static_assert(
+            std::is_trivially_copyable<value_type>::value,
+            "Must have trivially copyable elements to hash their bytes!"
+        );
+
+        Hasher hasher;
+        hash(r, hasher, is_contiguous<Range>());
+        return hasher.digest();
+    }
+
+private:
+
+    template <typename Range>
+    void hash(Range& r, Hasher& hasher, std::true_type)
+    {
+        hasher.update(
+            reinterpret_cast<const unsigned char*>(r.data()),
+            static_cast<std::size_t>(r.end() - r.begin()) * sizeof(*r.data())
+        );
+    }
+
+    template <typename Range>
+    void hash(Range& r, Hasher& hasher, std::false_type)
+    {
+        using value_type = value_type_t<Range>;
+
+        constexpr std::size_t buffer_size =
+            sizeof(value_type) >= buffer_bytes ? 1 : buffer_bytes / sizeof(value_type);
+
+        value_type  buffer[buffer_size];
+        std::size_t n = 0;
+
+        for(auto&& value : r) {
+            buffer[n] = value;
+            if(++n == buffer_size) {
+                hasher.update(reinterpret_cast<const unsigned char*>(buffer), sizeof(buffer));
+                n = 0;
+            }
+        }
+        hasher.update(reinterpret_cast<const unsigned char*>(buffer), n * sizeof(value_type));
+    }
+};
+
+} // end namespace detail
+
+// A digest of the bytes of every element of a range, in order. Elements
+// must be trivially copyable, and should have no padding (whose bytes are
+// unspecified). The digest is the same as hashing the elements laid out
+// in an array, however the pipeline producing them is built.
+template <typename Hasher = xxhash64>
+detail::inner_hash_into<Hasher> hash_into()
+{
+    return detail::inner_hash_into<Hasher>();
+}
+
+inline detail::inner_hash_into<crc32c_hasher> crc32c()
+{
+    return detail::inner_hash_into<crc32c_hasher>();
+}
+
+template <typename Range, typename Hasher>
+typename Hasher::result_type operator|(Range&& c, detail::inner_hash_into<Hasher> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
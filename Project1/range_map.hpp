@@ -3,6 +3,7 @@
 #include "iterator_helpers.hpp"
 
 #include <iterator>
+#include <memory>
 #include <type_traits>
 
 namespace adaptor
@@ -30,17 +31,18 @@ private:
 
 public:
 
-    using value_type = typename std::iterator_traits<base_iterator>::value_type;
+    using value_type = typename range_map<Range, UnaryFunc>::value_type;
+    using difference_type = difference_type_t<Range>;
     using iterator_category = iterator_category_t<Range>;
 
     range_map_iterator(range_map_type& r, base_iterator where)
-        : parent_(r),
+        : parent_(std::addressof(r)),
           current_(where)
     { }
 
     value_type operator*() 
     {
-        return parent_.func_(*current_);
+        return parent_->func_(*current_);
     }
 
     self_type& operator++()
@@ -55,37 +57,53 @@ public:
         return *this;
     }
 
-    template <typename T = self_type&>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::random_access_iterator_tag>::value,
-        T
-    >::type 
-    operator+(std::size_t n)
+    // Random access only.
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    self_type& operator+=(difference_type n)
     {
         current_ += n;
         return *this;
     }
 
-    template <typename T = self_type&>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::random_access_iterator_tag>::value,
-        T
-    >::type 
-    operator-(std::size_t n)
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    self_type& operator-=(difference_type n)
     {
         current_ -= n;
         return *this;
     }
 
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    self_type operator+(difference_type n) const
+    {
+        return self_type(*parent_, current_ + n);
+    }
+
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    self_type operator-(difference_type n) const
+    {
+        return self_type(*parent_, current_ - n);
+    }
+
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    difference_type operator-(const self_type& other) const
+    {
+        return current_ - other.current_;
+    }
+
     bool equals(self_type other) const
     {
-        return std::addressof(parent_) == std::addressof(other.parent_) &&
-            current_ == other.current_;
+        return parent_ == other.parent_ && current_ == other.current_;
+    }
+
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    bool less(self_type other) const
+    {
+        return current_ < other.current_;
     }
 
 private:
 
-    range_map_type& parent_;
+    range_map_type* parent_;
     base_iterator   current_;
 };
 
@@ -105,6 +123,38 @@ bool operator!=(
     return !operator==(r1, r2);
 }
 
+template <typename Range, typename UnaryFunc>
+auto operator<(
+    range_map_iterator<Range, UnaryFunc> r1, range_map_iterator<Range, UnaryFunc> r2
+) -> decltype(r1.less(r2))
+{
+    return r1.less(r2);
+}
+
+template <typename Range, typename UnaryFunc>
+auto operator>(
+    range_map_iterator<Range, UnaryFunc> r1, range_map_iterator<Range, UnaryFunc> r2
+) -> decltype(r1.less(r2))
+{
+    return r2.less(r1);
+}
+
+template <typename Range, typename UnaryFunc>
+auto operator<=(
+    range_map_iterator<Range, UnaryFunc> r1, range_map_iterator<Range, UnaryFunc> r2
+) -> decltype(r1.less(r2))
+{
+    return !r2.less(r1);
+}
+
+template <typename Range, typename UnaryFunc>
+auto operator>=(
+    range_map_iterator<Range, UnaryFunc> r1, range_map_iterator<Range, UnaryFunc> r2
+) -> decltype(r1.less(r2))
+{
+    return !r1.less(r2);
+}
+
 template <typename Range, typename UnaryFunc>
 struct range_map
 {
@@ -123,7 +173,7 @@ public:
 
     range_map(Range&& r, UnaryFunc func)
         : range_(std::forward<Range>(r)),
-          func_(func)
+          func_(std::move(func))
     { }
 
     iterator begin()
@@ -136,10 +186,67 @@ public:
         return iterator(*this, range_.end());
     }
 
+    // The underlying range and the function, for terminals and stages that
+    // can do better than walking the map's iterators (see map_lut).
+
+    std::remove_reference_t<Range>& base()
+    {
+        return range_;
+    }
+
+    UnaryFunc& function()
+    {
+        return func_;
+    }
+
+    // Splitting: a map has exactly as many elements as the range it maps
+    // over. If that range is splittable itself (e.g. a filter) its pieces
+    // are mapped, otherwise any [from, to) sub-range can be produced in 
+    // O(1) when the underlying range is random access. If neither, a map
+    // can't be split.
+
+    template <typename R = Range>
+    typename std::enable_if<is_splittable<R>::value, std::size_t>::type
+    split_size()
+    {
+        return range_.split_size();
+    }
+
+    template <typename R = Range>
+    typename std::enable_if<
+        !is_splittable<R>::value && is_random_access<R>::value, std::size_t
+    >::type
+    split_size()
+    {
+        return static_cast<std::size_t>(range_.end() - range_.begin());
+    }
+
+    template <typename R = Range>
+    typename std::enable_if<is_splittable<R>::value, iterator_range<iterator>>::type
+    split_range(std::size_t from, std::size_t to)
+    {
+        auto piece = range_.split_range(from, to);
+        return iterator_range<iterator>(
+            iterator(*this, piece.begin()), iterator(*this, piece.end())
+        );
+    }
+
+    template <typename R = Range>
+    typename std::enable_if<
+        !is_splittable<R>::value && is_random_access<R>::value, iterator_range<iterator>
+    >::type
+    split_range(std::size_t from, std::size_t to)
+    {
+        auto first = range_.begin();
+        return iterator_range<iterator>(
+            iterator(*this, first + from), iterator(*this, first + to)
+        );
+    }
+
 private:
 
-    Range&&    range_;
-    UnaryFunc  func_;
+    stored_range_t<Range> range_;
+    UnaryFunc             func_;
 };
 
 template <typename UnaryFunc>
@@ -148,16 +255,25 @@ struct inner_transform
     UnaryFunc f_;
 
     inner_transform(UnaryFunc f)
-        : f_(f)
+        : f_(std::move(f))
     { }
 
     template <typename Range>
-    auto operator()(Range&& r)
+    auto operator()(Range&& r) &
     {
         return detail::range_map<Range, UnaryFunc>(
             std::forward<Range>(r), f_
         );
     }
+
+    // Used by operator|, so move-only callables can be piped in directly.
+    template <typename Range>
+    auto operator()(Range&& r) &&
+    {
+        return detail::range_map<Range, UnaryFunc>(
+            std::forward<Range>(r), std::move(f_)
+        );
+    }
 };
 
 } // end namespace detail
@@ -181,13 +297,13 @@ auto range_transform(UnaryFunc f)
 template <typename UnaryFunc>
 detail::inner_transform<UnaryFunc> map(UnaryFunc f)
 {
-    return detail::inner_transform<UnaryFunc>(f);
+    return detail::inner_transform<UnaryFunc>(std::move(f));
 }
 
 template <typename Range, typename UnaryFunc>
 auto operator|(Range&& c, detail::inner_transform<UnaryFunc> inner)
 {
-    return inner(std::forward<Range>(c));
+    return std::move(inner)(std::forward<Range>(c));
 }
 
 } // end namespace adaptor
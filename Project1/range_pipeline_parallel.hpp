@@ -0,0 +1,340 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace adaptor
+{
+namespace detail
+{
+
+// A bounded, lock-free single producer / single consumer queue of slots.
+// Slots are filled and read in place, so once the ring has gone around
+// once (and the batches in it have grown to size) nothing is allocated.
+// The producer waits while the ring is full, which is what provides
+// backpressure to the upstream stages.
+template <typename T>
+struct spsc_ring
+{
+    explicit spsc_ring(std::size_t capacity)
+        : slots_(capacity),
+          head_(0),
+          tail_(0)
+    { }
+
+    // Producer side: the next free slot, or nullptr once stop is set.
+    T* acquire_write(const std::atomic<bool>& stop)
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        while(head - tail_.load(std::memory_order_acquire) == slots_.size()) {
+            if(stop.load(std::memory_order_acquire)) { return nullptr; }
+            std::this_thread::yield();
+        }
+        return &slots_[head % slots_.size()];
+    }
+
+    void publish()
+    {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // Consumer side: the oldest filled slot, or nullptr once done is set
+    // and the ring has been drained.
+    T* acquire_read(const std::atomic<bool>& done)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        while(tail == head_.load(std::memory_order_acquire)) {
+            if(done.load(std::memory_order_acquire)) {
+                if(tail != head_.load(std::memory_order_acquire)) { break; }
+                return nullptr;
+            }
+            std::this_thread::yield();
+        }
+        return &slots_[tail % slots_.size()];
+    }
+
+    void release()
+    {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+private:
+
+    // head_ is written by the producer and tail_ by the consumer. Keeping
+    // each on a cache line of its own stops every publish() and release()
+    // from taking the line away from the other thread. Padded rather than
+    // alignas(64): the ring is heap allocated, and plain new only honours
+    // over-alignment from C++17 on.
+    static constexpr std::size_t cache_line = 64;
+
+    std::vector<T>           slots_;
+    char                     head_pad_[cache_line];
+    std::atomic<std::size_t> head_;
+    char                     tail_pad_[cache_line];
+    std::atomic<std::size_t> tail_;
+    char                     end_pad_[cache_line];
+};
+
+//================================================================================
+
+// Everything shared between the producer thread and the consumer. It lives
+// on the heap so the range can be moved around freely, even after the
+// producer has started.
+template <typename Range>
+struct pipeline_parallel_state
+{
+    using value_type = value_type_t<Range>;
+    using batch_type = std::vector<value_type>;
+
+    pipeline_parallel_state(Range&& r, std::size_t batch_size, std::size_t batches)
+        : range_(std::forward<Range>(r)),
+          batch_size_(batch_size),
+          ring_(batches),
+          batch_(nullptr),
+          position_(0),
+          started_(false),
+          finished_(false),
+          done_(false),
+          stop_(false)
+    { }
+
+    ~pipeline_parallel_state()
+    {
+        stop_.store(true, std::memory_order_release);
+        if(producer_.joinable()) { producer_.join(); }
+    }
+
+    void start()
+    {
+        if(started_) { return; }
+        started_  = true;
+        producer_ = std::thread([this]() { produce(); });
+        next_batch();
+    }
+
+    // Runs on the producer thread: drains the upstream range into batches,
+    // until it runs out or the consumer is destroyed.
+    void produce()
+    {
+        try {
+            auto first = range_.begin();
+            auto last  = range_.end();
+            while(first != last && !stop_.load(std::memory_order_acquire)) {
+                auto* batch = ring_.acquire_write(stop_);
+                if(batch == nullptr) { break; }
+                batch->clear();
+                batch->reserve(batch_size_);
+                for(; first != last && batch->size() < batch_size_; ++first) {
+                    batch->push_back(*first);
+                }
+                ring_.publish();
+            }
+        }
+        catch(...) {
+            error_ = std::current_exception();
+        }
+        done_.store(true, std::memory_order_release);
+    }
+
+    // Consumer side: moves on to the next non-empty batch, or marks the
+    // range as finished (passing on anything the producer threw).
+    void next_batch()
+    {
+        if(batch_ != nullptr) { ring_.release(); }
+        batch_    = ring_.acquire_read(done_);
+        position_ = 0;
+        if(batch_ == nullptr) {
+            finished_ = true;
+            if(error_) { std::rethrow_exception(error_); }
+        }
+    }
+
+    void advance()
+    {
+        if(++position_ == batch_->size()) { next_batch(); }
+    }
+
+    stored_range_t<Range>  range_;
+    std::size_t            batch_size_;
+    spsc_ring<batch_type>  ring_;
+    batch_type*            batch_;
+    std::size_t            position_;
+    bool                   started_;
+    bool                   finished_;
+    std::atomic<bool>      done_;
+    std::atomic<bool>      stop_;
+    std::exception_ptr     error_;
+    std::thread            producer_;
+};
+
+template <typename Range>
+struct range_pipeline_parallel_iterator
+    : public std::iterator<
+        std::input_iterator_tag,
+        value_type_t<Range>
+      >
+{
+private:
+
+    using self_type  = range_pipeline_parallel_iterator<Range>;
+    using state_type = pipeline_parallel_state<Range>;
+
+public:
+
+    using value_type = value_type_t<Range>;
+    using reference  = const value_type&;
+
+    explicit range_pipeline_parallel_iterator(state_type* state)
+        : state_(state)
+    { }
+
+    reference operator*() const
+    {
+        return (*state_->batch_)[state_->position_];
+    }
+
+    self_type& operator++()
+    {
+        state_->advance();
+        return *this;
+    }
+
+    self_type operator++(int)
+    {
+        self_type ret(*this);
+        state_->advance();
+        return ret;
+    }
+
+    bool at_end() const
+    {
+        return state_ == nullptr || state_->finished_;
+    }
+
+    bool equals(self_type other) const
+    {
+        return at_end() == other.at_end();
+    }
+
+private:
+
+    state_type* state_;
+};
+
+template <typename Range>
+bool operator==(
+    range_pipeline_parallel_iterator<Range> r1, range_pipeline_parallel_iterator<Range> r2
+)
+{
+    return r1.equals(r2);
+}
+
+template <typename Range>
+bool operator!=(
+    range_pipeline_parallel_iterator<Range> r1, range_pipeline_parallel_iterator<Range> r2
+)
+{
+    return !operator==(r1, r2);
+}
+
+//================================================================================
+
+// A thread boundary in a pipeline. Everything upstream of it runs on its
+// own thread, which hands elements over in batches through a bounded
+// queue, so upstream and downstream stages work at the same time. Order
+// is preserved, so order dependent stages like unique() can follow.
+//
+// The producer thread starts on the first call to begin(), and the range
+// can only be iterated once. Destroying the range early stops the
+// producer at its next batch.
+template <typename Range>
+struct range_pipeline_parallel
+{
+private:
+
+    using state_type = pipeline_parallel_state<Range>;
+
+public:
+
+    using iterator   = range_pipeline_parallel_iterator<Range>;
+    using value_type = value_type_t<Range>;
+    using reference  = const value_type&;
+
+    range_pipeline_parallel(Range&& r, std::size_t batch_size, std::size_t batches)
+        : state_(new state_type(std::forward<Range>(r), batch_size, batches))
+    { }
+
+    iterator begin()
+    {
+        state_->start();
+        return iterator(state_.get());
+    }
+
+    iterator end()
+    {
+        return iterator(nullptr);
+    }
+
+private:
+
+    std::unique_ptr<state_type> state_;
+};
+
+struct inner_pipeline_parallel
+{
+    std::size_t batch_size_;
+    std::size_t batches_;
+
+    inner_pipeline_parallel(std::size_t batch_size, std::size_t batches)
+        : batch_size_(batch_size),
+          batches_(batches)
+    { }
+
+    template <typename Range>
+    auto operator()(Range&& r)
+    {
+        return detail::range_pipeline_parallel<Range>(
+            std::forward<Range>(r), batch_size_, batches_
+        );
+    }
+};
+
+} // end namespace detail
+
+// Put between two stages to run the stages before it on another thread:
+//
+//   x | filter(expensive_check) | pipeline_parallel()
+//     | map(parse) | pipeline_parallel()
+//     | unique()
+//
+// runs the filter, the map and the unique on three different threads.
+// batch_size elements are handed over at a time, and at most batches
+// batches can be waiting before the upstream thread blocks.
+inline detail::inner_pipeline_parallel pipeline_parallel(
+    std::size_t batch_size = 1024, std::size_t batches = 8
+)
+{
+    if(batch_size == 0 || batches == 0) {
+        throw std::invalid_argument("Batch size and number of batches must be > 0!");
+    }
+
+    return detail::inner_pipeline_parallel(batch_size, batches);
+}
+
+template <typename Range>
+auto operator|(Range&& c, detail::inner_pipeline_parallel inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
@@ -0,0 +1,218 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <xmmintrin.h>
+#endif
+
+namespace adaptor
+{
+namespace detail
+{
+
+inline void prefetch_address(const void* address)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(address);
+#elif defined(_MSC_VER)
+    _mm_prefetch(static_cast<const char*>(address), _MM_HINT_T0);
+#else
+    (void)address;
+#endif
+}
+
+template <typename Range, typename AddressFunc>
+struct range_prefetch;
+
+// Yields the elements of the underlying range unchanged, but keeps a second
+// iterator distance_ elements ahead and prefetches whatever address the
+// AddressFunc gives for that element. By the time a later stage (usually a
+// map doing a gather) gets to the element, its data should be in cache.
+template <typename Range, typename AddressFunc>
+struct range_prefetch_iterator
+    : public std::iterator<
+        std::forward_iterator_tag,
+        value_type_t<Range>,
+        difference_type_t<Range>
+      >
+{
+private:
+
+    using range_type          = typename std::remove_reference<Range>::type;
+    using self_type           = range_prefetch_iterator<Range, AddressFunc>;
+    using range_prefetch_type = range_prefetch<Range, AddressFunc>;
+    using base_iterator       = typename range_type::iterator;
+
+public:
+
+    using reference = typename std::iterator_traits<base_iterator>::reference;
+
+    // Forward iterators must be default constructible. A default
+    // constructed iterator can only be assigned to or compared with
+    // another default constructed one.
+    range_prefetch_iterator()
+        : parent_(nullptr),
+          current_(),
+          ahead_(),
+          end_()
+    { }
+
+    range_prefetch_iterator(
+        range_prefetch_type& r, base_iterator where, base_iterator ahead,
+        base_iterator end
+    )
+        : parent_(std::addressof(r)),
+          current_(where),
+          ahead_(ahead),
+          end_(end)
+    { }
+
+    reference operator*()
+    {
+        return *current_;
+    }
+
+    self_type& operator++()
+    {
+        if(ahead_ != end_) {
+            prefetch_address(parent_->func_(*ahead_));
+            ++ahead_;
+        }
+        ++current_;
+        return *this;
+    }
+
+    self_type operator++(int)
+    {
+        self_type ret(*this);
+        ++(*this);
+        return ret;
+    }
+
+    bool equals(self_type other) const
+    {
+        return parent_ == other.parent_ && current_ == other.current_;
+    }
+
+private:
+
+    range_prefetch_type* parent_;
+    base_iterator        current_;
+    base_iterator        ahead_;
+    base_iterator        end_;
+};
+
+template <typename Range, typename AddressFunc>
+bool operator==(
+    range_prefetch_iterator<Range, AddressFunc> r1,
+    range_prefetch_iterator<Range, AddressFunc> r2
+)
+{
+    return r1.equals(r2);
+}
+
+template <typename Range, typename AddressFunc>
+bool operator!=(
+    range_prefetch_iterator<Range, AddressFunc> r1,
+    range_prefetch_iterator<Range, AddressFunc> r2
+)
+{
+    return !operator==(r1, r2);
+}
+
+template <typename Range, typename AddressFunc>
+struct range_prefetch
+{
+    friend struct range_prefetch_iterator<Range, AddressFunc>;
+
+public:
+
+    using iterator   = range_prefetch_iterator<Range, AddressFunc>;
+    using value_type = value_type_t<Range>;
+    using reference  = typename std::iterator_traits<
+        typename std::remove_reference_t<Range>::iterator
+    >::reference;
+
+    range_prefetch(Range&& r, std::size_t distance, AddressFunc func)
+        : range_(std::forward<Range>(r)),
+          distance_(distance),
+          func_(func)
+    {
+        if(distance_ == 0) {
+            throw std::invalid_argument("Prefetch distance must be > 0!");
+        }
+    }
+
+    // Starting an iteration issues the prefetches for the first distance_
+    // elements up front, so the lookahead is full from the first element.
+    iterator begin()
+    {
+        auto ahead = range_.begin();
+        auto end   = range_.end();
+        for(auto i = 0U; i < distance_ && ahead != end; ++i, ++ahead) {
+            prefetch_address(func_(*ahead));
+        }
+        return iterator(*this, range_.begin(), ahead, end);
+    }
+
+    iterator end()
+    {
+        return iterator(*this, range_.end(), range_.end(), range_.end());
+    }
+
+private:
+
+    stored_range_t<Range> range_;
+    std::size_t           distance_;
+    AddressFunc           func_;
+};
+
+template <typename AddressFunc>
+struct inner_prefetch
+{
+    std::size_t distance_;
+    AddressFunc f_;
+
+    inner_prefetch(std::size_t distance, AddressFunc f)
+        : distance_(distance),
+          f_(f)
+    { }
+
+    template <typename Range>
+    auto operator()(Range&& r)
+    {
+        static_assert(
+            std::is_base_of<std::forward_iterator_tag, iterator_category_t<Range>>::value,
+            "Must have at least forward iterators to prefetch ahead!"
+        );
+
+        return detail::range_prefetch<Range, AddressFunc>(
+            std::forward<Range>(r), distance_, f_
+        );
+    }
+};
+
+} // end namespace detail
+
+// addr_fn maps an element to the address a later stage is going to load,
+// e.g. [&table](std::uint32_t i) { return &table[i]; } in front of a
+// map([&table](std::uint32_t i) { return table[i]; }).
+template <typename AddressFunc>
+detail::inner_prefetch<AddressFunc> prefetch(std::size_t distance, AddressFunc addr_fn)
+{
+    return detail::inner_prefetch<AddressFunc>(distance, addr_fn);
+}
+
+template <typename Range, typename AddressFunc>
+auto operator|(Range&& c, detail::inner_prefetch<AddressFunc> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
@@ -4,45 +4,66 @@
 
 #include <iterator>
 #include <type_traits>
+#include <utility>
 
 namespace adaptor
 {
 namespace detail
 {
 
-//================================================================================
+// Ranges with contiguous storage are reversed over plain pointers, which
+// compilers have a much easier time vectorizing than a wrapped class
+// iterator.
+template <typename Range, bool = is_contiguous<Range>::value>
+struct reverse_base_iterator
+{
+    using type = typename std::remove_reference<Range>::type::iterator;
+};
 
 template <typename Range>
-struct range_reverse_iterator 
+struct reverse_base_iterator<Range, true>
+{
+    using type = decltype(
+        std::declval<typename std::remove_reference<Range>::type&>().data()
+    );
+};
+
+template <typename Range>
+using reverse_base_iterator_t = typename reverse_base_iterator<Range>::type;
+
+//================================================================================
+
+// Uses the same convention as std::reverse_iterator: the iterator holds the
+// position one past the element it refers to in the underlying range, so
+// the reversed begin and end are the underlying end and begin, and nothing
+// ever steps before the start of the underlying range.
+template <typename BaseIterator>
+struct range_reverse_iterator
     : public std::iterator<
-        iterator_category_t<Range>,
-        typename Range::value_type
+        typename std::iterator_traits<BaseIterator>::iterator_category,
+        typename std::iterator_traits<BaseIterator>::value_type,
+        typename std::iterator_traits<BaseIterator>::difference_type
       >
 {
 private:
 
-    using range_type    = typename std::remove_reference<Range>::type;
-    using self_type     = range_reverse_iterator<Range>;
-    using base_iterator = typename range_type::iterator;
+    using self_type = range_reverse_iterator<BaseIterator>;
 
 public:
 
-    using value_type        = typename range_type::value_type;
-    using reference         = value_type&;
-    using iterator_category = iterator_category_t<Range>;
+    using value_type        = typename std::iterator_traits<BaseIterator>::value_type;
+    using difference_type   = typename std::iterator_traits<BaseIterator>::difference_type;
+    using reference         = decltype(*std::declval<BaseIterator&>());
+    using iterator_category = typename std::iterator_traits<BaseIterator>::iterator_category;
 
-    range_reverse_iterator(base_iterator where)
+    explicit range_reverse_iterator(BaseIterator where)
         : current_(where)
     { }
 
-    auto operator*() 
-    {
-        return *current_;
-    }
-
-    auto operator*() const
+    reference operator*() const
     {
-        return *current_;
+        auto element = current_;
+        return *--element;
     }
 
     self_type& operator++()
@@ -58,66 +79,146 @@ public:
         return ret;
     }
 
-    template <typename T = self_type>
-    typename std::enable_if<
-        std::is_same<std::random_access_iterator_tag, iterator_category>::value 
-    >::type operator+(std::ptrdiff_t n)
+    self_type& operator--()
+    {
+        ++current_;
+        return *this;
+    }
+
+    self_type operator--(int)
     {
         self_type ret(*this);
-        current_ -= n;
+        ++current_;
         return ret;
     }
-    
-    template <typename T = self_type&>
-    typename std::enable_if<
-        std::is_same<std::random_access_iterator_tag, iterator_category>::value
-    >::type operator+=(std::ptrdiff_t n)
+
+    // Random access only.
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    self_type& operator+=(difference_type n)
     {
         current_ -= n;
         return *this;
     }
 
-    self_type& operator--()
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    self_type& operator-=(difference_type n)
     {
-        ++current_;
+        current_ += n;
         return *this;
     }
 
-    self_type operator--(int)
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    self_type operator+(difference_type n) const
     {
-        self_type ret(*this);
-        ++current_;
-        return ret;
+        return self_type(current_ - n);
     }
-   
-    bool equals(self_type other) const
+
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    self_type operator-(difference_type n) const
+    {
+        return self_type(current_ + n);
+    }
+
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    difference_type operator-(const self_type& other) const
+    {
+        return other.current_ - current_;
+    }
+
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    reference operator[](difference_type n) const
+    {
+        return *(current_ - n - 1);
+    }
+
+    // The position in the underlying range, one past the element this
+    // iterator refers to.
+    BaseIterator base() const
+    {
+        return current_;
+    }
+
+    bool equals(const self_type& other) const
     {
         return current_ == other.current_;
     }
 
+    template <typename C = iterator_category, typename = enable_if_random_access_t<C>>
+    bool less(const self_type& other) const
+    {
+        return other.current_ < current_;
+    }
+
 private:
 
-    base_iterator current_;
+    BaseIterator current_;
 };
 
 //================================================================================
 
-template <typename Range>
+template <typename BaseIterator>
 bool operator==(
-    range_reverse_iterator<Range> r1, range_reverse_iterator<Range> r2
+    const range_reverse_iterator<BaseIterator>& r1,
+    const range_reverse_iterator<BaseIterator>& r2
 )
 {
     return r1.equals(r2);
 }
 
-template <typename Range>
+template <typename BaseIterator>
 bool operator!=(
-    range_reverse_iterator<Range> r1, range_reverse_iterator<Range> r2
+    const range_reverse_iterator<BaseIterator>& r1,
+    const range_reverse_iterator<BaseIterator>& r2
 )
 {
     return !operator==(r1, r2);
 }
 
+template <typename BaseIterator>
+auto operator<(
+    const range_reverse_iterator<BaseIterator>& r1,
+    const range_reverse_iterator<BaseIterator>& r2
+) -> decltype(r1.less(r2))
+{
+    return r1.less(r2);
+}
+
+template <typename BaseIterator>
+auto operator>(
+    const range_reverse_iterator<BaseIterator>& r1,
+    const range_reverse_iterator<BaseIterator>& r2
+) -> decltype(r1.less(r2))
+{
+    return r2.less(r1);
+}
+
+template <typename BaseIterator>
+auto operator<=(
+    const range_reverse_iterator<BaseIterator>& r1,
+    const range_reverse_iterator<BaseIterator>& r2
+) -> decltype(r1.less(r2))
+{
+    return !r2.less(r1);
+}
+
+template <typename BaseIterator>
+auto operator>=(
+    const range_reverse_iterator<BaseIterator>& r1,
+    const range_reverse_iterator<BaseIterator>& r2
+) -> decltype(r1.less(r2))
+{
+    return !r1.less(r2);
+}
+
+template <typename BaseIterator>
+auto operator+(
+    typename range_reverse_iterator<BaseIterator>::difference_type n,
+    const range_reverse_iterator<BaseIterator>& r
+) -> decltype(r + n)
+{
+    return r + n;
+}
+
 //================================================================================
 
 template <typename Range>
@@ -125,12 +226,13 @@ struct range_reverse
 {
 private:
 
-    using range_type = typename std::remove_reference_t<Range>;
+    using range_type    = typename std::remove_reference_t<Range>;
+    using base_iterator = reverse_base_iterator_t<Range>;
 
 public:
 
-    using iterator   = range_reverse_iterator<range_type>;
-    using reference  = typename range_type::reference;
+    using iterator   = range_reverse_iterator<base_iterator>;
+    using reference  = typename iterator::reference;
     using value_type = typename range_type::value_type;
 
     range_reverse(Range&& c)
@@ -144,21 +246,57 @@ public:
 
     iterator begin()
     {
-        auto end = range_.end();
-        --end;
-        return iterator(end);
+        return iterator(base_end(is_contiguous<Range>()));
     }
 
     iterator end()
     {
-        auto begin = range_.begin();
-        --begin;
-        return iterator(begin);
+        return iterator(base_begin(is_contiguous<Range>()));
+    }
+
+    // Splitting: element i of the reversed range is element (n - 1 - i) of
+    // the underlying range, which is O(1) to reach for random access ranges.
+
+    std::size_t split_size()
+    {
+        return static_cast<std::size_t>(
+            std::distance(range_.begin(), range_.end())
+        );
+    }
+
+    iterator_range<iterator> split_range(std::size_t from, std::size_t to)
+    {
+        using difference_type = typename iterator::difference_type;
+        auto last = base_end(is_contiguous<Range>());
+        return iterator_range<iterator>(
+            iterator(std::prev(last, static_cast<difference_type>(from))),
+            iterator(std::prev(last, static_cast<difference_type>(to)))
+        );
     }
 
 private:
-    
-    Range&& range_;
+
+    base_iterator base_begin(std::true_type)
+    {
+        return range_.data();
+    }
+
+    base_iterator base_end(std::true_type)
+    {
+        return range_.data() + (range_.end() - range_.begin());
+    }
+
+    base_iterator base_begin(std::false_type)
+    {
+        return range_.begin();
+    }
+
+    base_iterator base_end(std::false_type)
+    {
+        return range_.end();
+    }
+
+    stored_range_t<Range> range_;
 };
 
 } // end namespace detail
@@ -166,16 +304,26 @@ private:
 auto reverse()
 {
     return [](auto&& container) -> detail::range_reverse<decltype(container)>
-    { 
+    {
         return detail::range_reverse<decltype(container)>(
             std::forward<decltype(container)>(container)
-        ); 
+        );
     };
 }
 
 template <typename Range>
-detail::range_reverse<Range> unique(Range&& c)
+detail::range_reverse<Range> reverse(Range&& c)
 {
+    using iterator_type = typename std::remove_reference_t<Range>::iterator;
+
+    static_assert(
+        std::is_base_of<
+            std::bidirectional_iterator_tag,
+            typename std::iterator_traits<iterator_type>::iterator_category
+        >::value,
+        "Must have at least bidirectional iterators for range reverse!"
+    );
+
     return detail::range_reverse<Range>(std::forward<Range>(c));
 }
 
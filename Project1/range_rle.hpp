@@ -0,0 +1,327 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+#include "range_group_by.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace adaptor
+{
+namespace detail
+{
+
+struct rle_key
+{
+    template <typename T>
+    const T& operator()(const T& value) const
+    {
+        return value;
+    }
+};
+
+struct rle_count
+{
+    template <typename T>
+    std::size_t operator()(std::size_t n, const T&) const
+    {
+        return n + 1;
+    }
+};
+
+//================================================================================
+
+template <typename Range>
+struct range_from_rle;
+
+// Refers to an element by its position in the expanded range, and keeps
+// track of the run holding that position so that stepping is O(1). Jumps
+// find the run with a binary search over the runs' end positions.
+template <typename Range>
+struct range_from_rle_iterator
+    : public std::iterator<
+        std::random_access_iterator_tag,
+        typename range_from_rle<Range>::value_type,
+        std::ptrdiff_t
+      >
+{
+private:
+
+    using self_type           = range_from_rle_iterator<Range>;
+    using range_from_rle_type = range_from_rle<Range>;
+
+public:
+
+    using value_type      = typename range_from_rle_type::value_type;
+    using reference       = typename range_from_rle_type::reference;
+    using difference_type = std::ptrdiff_t;
+
+    range_from_rle_iterator(const range_from_rle_type& r, std::size_t position)
+        : parent_(std::addressof(r)),
+          position_(position),
+          run_(r.run_of(position))
+    { }
+
+    reference operator*() const
+    {
+        return parent_->value_of(run_);
+    }
+
+    reference operator[](difference_type n) const
+    {
+        return *(*this + n);
+    }
+
+    self_type& operator++()
+    {
+        ++position_;
+        while(run_ < parent_->ends_.size() && parent_->ends_[run_] <= position_) {
+            ++run_;
+        }
+        return *this;
+    }
+
+    self_type operator++(int)
+    {
+        self_type ret(*this);
+        ++(*this);
+        return ret;
+    }
+
+    self_type& operator--()
+    {
+        --position_;
+        while(run_ > 0 && parent_->ends_[run_ - 1] > position_) {
+            --run_;
+        }
+        return *this;
+    }
+
+    self_type operator--(int)
+    {
+        self_type ret(*this);
+        --(*this);
+        return ret;
+    }
+
+    self_type& operator+=(difference_type n)
+    {
+        position_ = static_cast<std::size_t>(static_cast<difference_type>(position_) + n);
+        run_      = parent_->run_near(run_, position_);
+        return *this;
+    }
+
+    self_type& operator-=(difference_type n)
+    {
+        return *this += -n;
+    }
+
+    self_type operator+(difference_type n) const
+    {
+        self_type ret(*this);
+        return ret += n;
+    }
+
+    self_type operator-(difference_type n) const
+    {
+        self_type ret(*this);
+        return ret -= n;
+    }
+
+    difference_type operator-(const self_type& other) const
+    {
+        return static_cast<difference_type>(position_)
+             - static_cast<difference_type>(other.position_);
+    }
+
+    bool equals(const self_type& other) const
+    {
+        return position_ == other.position_;
+    }
+
+    bool less(const self_type& other) const
+    {
+        return position_ < other.position_;
+    }
+
+private:
+
+    const range_from_rle_type* parent_;
+    std::size_t                position_;
+    std::size_t                run_;
+};
+
+template <typename Range>
+bool operator==(const range_from_rle_iterator<Range>& r1, const range_from_rle_iterator<Range>& r2)
+{
+    return r1.equals(r2);
+}
+
+template <typename Range>
+bool operator!=(const range_from_rle_iterator<Range>& r1, const range_from_rle_iterator<Range>& r2)
+{
+    return !operator==(r1, r2);
+}
+
+template <typename Range>
+bool operator<(const range_from_rle_iterator<Range>& r1, const range_from_rle_iterator<Range>& r2)
+{
+    return r1.less(r2);
+}
+
+template <typename Range>
+bool operator>(const range_from_rle_iterator<Range>& r1, const range_from_rle_iterator<Range>& r2)
+{
+    return r2.less(r1);
+}
+
+template <typename Range>
+bool operator<=(const range_from_rle_iterator<Range>& r1, const range_from_rle_iterator<Range>& r2)
+{
+    return !r2.less(r1);
+}
+
+template <typename Range>
+bool operator>=(const range_from_rle_iterator<Range>& r1, const range_from_rle_iterator<Range>& r2)
+{
+    return !r1.less(r2);
+}
+
+template <typename Range>
+range_from_rle_iterator<Range> operator+(
+    typename range_from_rle_iterator<Range>::difference_type n,
+    const range_from_rle_iterator<Range>& r
+)
+{
+    return r + n;
+}
+
+//================================================================================
+
+// The expanded view of a range of (value, run length) pairs, as produced
+// by rle(). Only the end position of each run is stored (built once, on
+// construction), so the view costs one std::size_t per run on top of the
+// runs themselves.
+template <typename Range>
+struct range_from_rle
+{
+    friend struct range_from_rle_iterator<Range>;
+
+    using run_type = value_type_t<Range>;
+
+public:
+
+    using iterator   = range_from_rle_iterator<Range>;
+    using value_type = std::decay_t<typename run_type::first_type>;
+    using reference  = const value_type&;
+
+    range_from_rle(Range&& runs)
+        : runs_(std::forward<Range>(runs))
+    {
+        std::size_t end = 0;
+        ends_.reserve(static_cast<std::size_t>(std::distance(runs_.begin(), runs_.end())));
+        for(auto&& run : runs_) {
+            end += run.second;
+            ends_.push_back(end);
+        }
+    }
+
+    iterator begin() const
+    {
+        return iterator(*this, 0);
+    }
+
+    iterator end() const
+    {
+        return iterator(*this, size());
+    }
+
+    std::size_t size() const
+    {
+        return ends_.empty() ? 0 : ends_.back();
+    }
+
+    reference operator[](std::size_t n) const
+    {
+        return value_of(run_of(n));
+    }
+
+    std::size_t split_size() const
+    {
+        return size();
+    }
+
+    iterator_range<iterator> split_range(std::size_t from, std::size_t to) const
+    {
+        return iterator_range<iterator>(iterator(*this, from), iterator(*this, to));
+    }
+
+private:
+
+    // The run holding position n (the number of runs for the end).
+    std::size_t run_of(std::size_t n) const
+    {
+        return static_cast<std::size_t>(
+            std::upper_bound(ends_.begin(), ends_.end(), n) - ends_.begin()
+        );
+    }
+
+    // As run_of, but looks at the few runs around a known one first: short
+    // jumps of an iterator (it += 3, say) mostly land in the same or the
+    // next run. stride() doesn't benefit, since its iterators jump from
+    // begin() to every element they visit.
+    std::size_t run_near(std::size_t run, std::size_t n) const
+    {
+        for(int i = 0; i < 4; ++i) {
+            if(run < ends_.size() && ends_[run] <= n) {
+                ++run;
+            }
+            else if(run > 0 && ends_[run - 1] > n) {
+                --run;
+            }
+            else {
+                return run;
+            }
+        }
+        return run_of(n);
+    }
+
+    reference value_of(std::size_t run) const
+    {
+        return std::next(runs_.begin(), static_cast<std::ptrdiff_t>(run))->first;
+    }
+
+    stored_range_t<Range>    runs_;
+    std::vector<std::size_t> ends_;
+};
+
+} // end namespace detail
+
+// Turns each run of equal consecutive elements into a (value, run length)
+// pair, e.g. collect it to store a repetitive column compactly.
+inline auto rle()
+{
+    return aggregate_by(detail::rle_key(), detail::rle_count(), std::size_t(0));
+}
+
+// The elements a range of (value, run length) pairs stands for, without
+// expanding them: size() is O(1), and jumping to a position (operator[],
+// iterator arithmetic, and so stride() and slice()) is O(log runs). The
+// runs must be random access (e.g. the result of rle() | collect()).
+template <typename Range>
+detail::range_from_rle<Range> from_rle(Range&& runs)
+{
+    static_assert(
+        detail::is_random_access<Range>::value,
+        "Must have random access iterators over the runs for from_rle!"
+    );
+
+    return detail::range_from_rle<Range>(std::forward<Range>(runs));
+}
+
+} // end namespace adaptor
@@ -0,0 +1,306 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+#include "range_collect.hpp"
+
+#include <algorithm>
+#include <array>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace adaptor
+{
+namespace detail
+{
+
+// Maps a key to an unsigned integer of the same width that orders the
+// same way, so it can be radix sorted one byte at a time.
+template <typename Key, typename = void>
+struct radix_key
+{
+    static constexpr bool value = false;
+};
+
+template <typename Key>
+struct radix_key<Key, std::enable_if_t<std::is_integral<Key>::value && !std::is_same<Key, bool>::value>>
+{
+    static constexpr bool value = true;
+
+    using type = std::make_unsigned_t<Key>;
+
+    static type encode(Key key)
+    {
+        // Flipping the sign bit puts negative numbers first.
+        return std::is_signed<Key>::value
+            ? static_cast<type>(static_cast<type>(key) ^ (type(1) << (sizeof(Key) * CHAR_BIT - 1)))
+            : static_cast<type>(key);
+    }
+};
+
+template <typename Key>
+struct radix_key<Key, std::enable_if_t<
+    std::is_floating_point<Key>::value && (sizeof(Key) == 4 || sizeof(Key) == 8)
+>>
+{
+    static constexpr bool value = true;
+
+    using type = std::conditional_t<sizeof(Key) == 4, std::uint32_t, std::uint64_t>;
+
+    // IEEE 754: flipping the sign bit orders positive numbers after
+    // negative ones, and flipping all bits of negative numbers reverses
+    // their order. -0.0 is encoded as 0.0, since the two compare equal and
+    // so must keep their order. NaNs end up at either end, depending on
+    // their sign.
+    static type encode(Key key)
+    {
+        type bits;
+        std::memcpy(&bits, &key, sizeof(bits));
+        const type sign = type(1) << (sizeof(Key) * CHAR_BIT - 1);
+        if(bits == sign) { return sign; }
+        return (bits & sign) ? type(~bits) : type(bits ^ sign);
+    }
+};
+
+// Below this many elements, radix sorting runs on a single thread.
+constexpr std::size_t radix_parallel_size = std::size_t(1) << 20;
+
+// Stable LSD radix sort, one byte per pass, between values and a buffer
+// of the same size. The elements are cut into one chunk per thread: each
+// pass counts the digits of every chunk, works out where each chunk's
+// elements of each digit go, and then moves every chunk into place. Passes
+// where all elements have the same digit are skipped.
+template <typename T, typename KeyFunc>
+void radix_sort(std::vector<T>& values, KeyFunc& key, std::size_t threads)
+{
+    using key_type   = std::decay_t<std::result_of_t<KeyFunc&(const T&)>>;
+    using encoder    = radix_key<key_type>;
+    using count_type = std::array<std::size_t, 256>;
+
+    const auto n = values.size();
+    if(n < radix_parallel_size) { threads = 1; }
+
+    std::vector<T> buffer(n);
+    std::vector<count_type> counts(threads);
+    T* source = values.data();
+    T* target = buffer.data();
+
+    auto for_each_chunk = [threads, n](auto&& func) {
+        std::vector<std::future<void>> workers;
+        workers.reserve(threads - 1);
+        for(std::size_t t = 1; t < threads; ++t) {
+            workers.push_back(std::async(std::launch::async, [&func, t, threads, n]() {
+                func(t, n * t / threads, n * (t + 1) / threads);
+            }));
+        }
+        func(0, 0, n / threads);
+        for(auto& worker : workers) {
+            worker.get();
+        }
+    };
+
+    // On a single thread the counts don't depend on the order of the
+    // elements, so all digits are counted in one go.
+    constexpr std::size_t digits = sizeof(typename encoder::type);
+    std::vector<count_type> all_counts(threads == 1 ? digits : 0);
+    if(threads == 1) {
+        for(auto& count : all_counts) { count.fill(0); }
+        for(std::size_t i = 0; i != n; ++i) {
+            const auto encoded = encoder::encode(key(source[i]));
+            for(std::size_t digit = 0; digit < digits; ++digit) {
+                ++all_counts[digit][(encoded >> (digit * CHAR_BIT)) & 0xff];
+            }
+        }
+    }
+
+    for(std::size_t digit = 0; digit < digits; ++digit) {
+        const auto shift = digit * CHAR_BIT;
+
+        if(threads == 1) {
+            counts[0] = all_counts[digit];
+        }
+        else {
+            for_each_chunk([&](std::size_t t, std::size_t first, std::size_t last) {
+                auto& count = counts[t];
+                count.fill(0);
+                for(auto i = first; i != last; ++i) {
+                    ++count[(encoder::encode(key(source[i])) >> shift) & 0xff];
+                }
+            });
+        }
+
+        // Turn the counts into where each chunk starts writing each digit.
+        std::size_t offset = 0;
+        bool        sorted = false;
+        for(std::size_t d = 0; d < 256; ++d) {
+            std::size_t total = 0;
+            for(auto& count : counts) {
+                const auto c = count[d];
+                count[d] = offset + total;
+                total   += c;
+            }
+            sorted  = sorted || total == n;
+            offset += total;
+        }
+        if(sorted) { continue; }
+
+        for_each_chunk([&](std::size_t t, std::size_t first, std::size_t last) {
+            auto& position = counts[t];
+            for(auto i = first; i != last; ++i) {
+                target[position[(encoder::encode(key(source[i])) >> shift) & 0xff]++] = source[i];
+            }
+        });
+
+        std::swap(source, target);
+    }
+
+    if(source != values.data()) {
+        values.swap(buffer);
+    }
+}
+
+template <typename T, typename KeyFunc>
+void sort_by(std::vector<T>& values, KeyFunc& key, std::size_t threads, std::true_type)
+{
+    radix_sort(values, key, threads);
+}
+
+template <typename T, typename KeyFunc>
+void sort_by(std::vector<T>& values, KeyFunc& key, std::size_t, std::false_type)
+{
+    std::stable_sort(values.begin(), values.end(), [&key](const T& a, const T& b) {
+        return key(a) < key(b);
+    });
+}
+
+//================================================================================
+
+// The output of an upstream pipeline, sorted and owned. Acts as a
+// contiguous random access source.
+template <typename T>
+struct range_sorted
+{
+public:
+
+    using iterator   = typename std::vector<T>::iterator;
+    using value_type = T;
+    using reference  = T&;
+
+    template <typename Range, typename KeyFunc>
+    range_sorted(Range&& r, KeyFunc& key, std::size_t threads)
+    {
+        using key_type = std::decay_t<std::result_of_t<KeyFunc&(const T&)>>;
+
+        append_to(r, values_);
+        sort_by(values_, key, threads, std::integral_constant<bool,
+            radix_key<key_type>::value && std::is_trivial<T>::value
+        >());
+    }
+
+    iterator begin()
+    {
+        return values_.begin();
+    }
+
+    iterator end()
+    {
+        return values_.end();
+    }
+
+    T* data()
+    {
+        return values_.data();
+    }
+
+    std::size_t size() const
+    {
+        return values_.size();
+    }
+
+    T& operator[](std::size_t n)
+    {
+        return values_[n];
+    }
+
+    std::size_t split_size() const
+    {
+        return values_.size();
+    }
+
+    iterator_range<iterator> split_range(std::size_t from, std::size_t to)
+    {
+        return iterator_range<iterator>(begin() + from, begin() + to);
+    }
+
+private:
+
+    std::vector<T> values_;
+};
+
+struct sorted_identity
+{
+    template <typename T>
+    const T& operator()(const T& value) const
+    {
+        return value;
+    }
+};
+
+template <typename KeyFunc>
+struct inner_sorted
+{
+    KeyFunc     key_;
+    std::size_t threads_;
+
+    inner_sorted(KeyFunc key, std::size_t threads)
+        : key_(std::move(key)),
+          threads_(threads)
+    { }
+
+    template <typename Range>
+    auto operator()(Range&& r)
+    {
+        return detail::range_sorted<value_type_t<Range>>(r, key_, threads_);
+    }
+};
+
+} // end namespace detail
+
+// Runs the upstream pipeline and sorts its output by key_fn(element),
+// stably, in ascending order. Integral and float keys are radix sorted
+// (on several threads for large inputs), which needs trivial elements and
+// a cheap key_fn, as it is called a couple of times per element and byte
+// of the key; anything else is std::stable_sort()ed.
+//
+//   x | sorted() | unique()
+//
+// removes all duplicates from x.
+template <typename KeyFunc>
+detail::inner_sorted<KeyFunc> sorted(
+    KeyFunc key_fn, std::size_t threads = std::thread::hardware_concurrency()
+)
+{
+    return detail::inner_sorted<KeyFunc>(
+        std::move(key_fn), std::max<std::size_t>(threads, 1)
+    );
+}
+
+inline detail::inner_sorted<detail::sorted_identity> sorted()
+{
+    return sorted(detail::sorted_identity());
+}
+
+template <typename Range, typename KeyFunc>
+auto operator|(Range&& c, detail::inner_sorted<KeyFunc> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace adaptor
+{
+
+// Splitting a range into independent pieces, e.g. to hand each one to a
+// different thread. Any adaptor exposing the following two members can be
+// split:
+//
+//   std::size_t split_size();
+//       The number of positions the range can be cut at. For most adaptors
+//       this is the number of elements; for filter() and unique() (and
+//       stages stacked on them) it is the size of the underlying range.
+//
+//   detail::iterator_range<iterator> split_range(std::size_t from, std::size_t to);
+//       The piece covering positions [from, to).
+//
+// Pieces refer back to the range they were split from, so it must outlive
+// them. Splitting a pipeline doesn't run any of its stages.
+//
+// Adaptors only have these members when they can actually be split (e.g.
+// a map over a std::list or a generator can't), so is_splittable tells
+// whether a pipeline can be split.
+
+template <typename Range>
+using split_piece_t =
+    decltype(std::declval<Range&>().split_range(std::size_t(), std::size_t()));
+
+template <typename Range>
+std::pair<split_piece_t<Range>, split_piece_t<Range>>
+split_at(Range& r, std::size_t where)
+{
+    const auto size = r.split_size();
+    if(where > size) {
+        throw std::out_of_range("Split position is past the end of the range!");
+    }
+
+    return std::make_pair(r.split_range(0, where), r.split_range(where, size));
+}
+
+template <typename Range>
+std::vector<split_piece_t<Range>> split(Range& r, std::size_t pieces)
+{
+    if(pieces == 0) {
+        throw std::invalid_argument("Number of pieces must be > 0!");
+    }
+
+    const auto size = r.split_size();
+    std::vector<split_piece_t<Range>> result;
+    result.reserve(pieces);
+
+    for(std::size_t i = 0; i < pieces; ++i) {
+        result.push_back(
+            r.split_range(size * i / pieces, size * (i + 1) / pieces)
+        );
+    }
+
+    return result;
+}
+
+//================================================================================
+
+namespace detail
+{
+
+// Cutting a range into pieces for terminals that also accept plain random
+// access ranges (e.g. a std::vector): splittable ranges cut themselves,
+// random access ones are cut with iterator arithmetic.
+
+template <typename Range>
+typename std::enable_if<is_splittable<Range>::value, std::size_t>::type
+piece_count(Range& r)
+{
+    return r.split_size();
+}
+
+template <typename Range>
+typename std::enable_if<!is_splittable<Range>::value, std::size_t>::type
+piece_count(Range& r)
+{
+    return static_cast<std::size_t>(r.end() - r.begin());
+}
+
+template <typename Range>
+auto piece(Range& r, std::size_t from, std::size_t to)
+    -> typename std::enable_if<
+        is_splittable<Range>::value, decltype(r.split_range(from, to))
+    >::type
+{
+    return r.split_range(from, to);
+}
+
+template <typename Range>
+auto piece(Range& r, std::size_t from, std::size_t to)
+    -> typename std::enable_if<
+        !is_splittable<Range>::value, iterator_range<decltype(r.begin())>
+    >::type
+{
+    auto first = r.begin();
+    return iterator_range<decltype(r.begin())>(first + from, first + to);
+}
+
+//================================================================================
+
+// For cutting one range into pieces from several threads. begin() is taken
+// once, up front: for some adaptors it does work (drop_while() scans the
+// prefix it drops), which piece() would otherwise redo for every piece,
+// concurrently.
+template <typename Range, bool = is_splittable<Range>::value>
+struct piece_cutter
+{
+    explicit piece_cutter(Range& r)
+        : range_(r)
+    { }
+
+    std::size_t size() const
+    {
+        return range_.split_size();
+    }
+
+    auto operator()(std::size_t from, std::size_t to) const
+    {
+        return range_.split_range(from, to);
+    }
+
+private:
+
+    Range& range_;
+};
+
+template <typename Range>
+struct piece_cutter<Range, false>
+{
+private:
+
+    using iterator = decltype(std::declval<Range&>().begin());
+
+public:
+
+    explicit piece_cutter(Range& r)
+        : first_(r.begin()),
+          size_(static_cast<std::size_t>(r.end() - first_))
+    { }
+
+    std::size_t size() const
+    {
+        return size_;
+    }
+
+    iterator_range<iterator> operator()(std::size_t from, std::size_t to) const
+    {
+        return iterator_range<iterator>(first_ + from, first_ + to);
+    }
+
+private:
+
+    iterator    first_;
+    std::size_t size_;
+};
+
+} // end namespace detail
+
+} // end namespace adaptor
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "iterator_helpers.hpp"
+
 #include <iterator>
 #include <stdexcept>
 #include <type_traits>
@@ -9,15 +11,11 @@ namespace adaptor
 namespace detail
 {
 
-template <typename Range>
-using iterator_category_t = 
-    typename std::iterator_traits<
-        typename std::remove_reference<Range>::type
-    ::iterator>::iterator_category;
-
 template <typename Range>
 struct range_stride;
 
+// Without random access, a stride steps through the underlying range one
+// element at a time, stopping at its end.
 template <typename Range>
 struct range_stride_iterator
     : public std::iterator<
@@ -35,7 +33,8 @@ private:
 public:
 
     using value_type        = typename range_type::value_type;
-    using reference         = value_type&;
+    using reference         = decltype(*std::declval<base_iterator&>());
+    using difference_type   = difference_type_t<Range>;
     using iterator_category = iterator_category_t<Range>;
 
     range_stride_iterator(
@@ -51,139 +50,204 @@ public:
         return *current_;
     }
 
-    template <typename T = self_type&>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::bidirectional_iterator_tag>::value,
-        T
-    >::type operator++()
+    self_type& operator++()
     {
-        auto i = 0U;
-        while(i < stride_ && current_ != end_) { ++current_; ++i; }
+        step_forward();
         return *this;
     }
 
-    template <typename T = self_type&>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::random_access_iterator_tag>::value,
-        T
-    >::type operator++()
+    self_type operator++(int)
+    {
+        self_type ret(*this);
+        step_forward();
+        return ret;
+    }
+
+    self_type& operator--()
     {
-        if(current_ + stride_ > end_) { current_ = end_; }
-        else { current_ += stride_; }
+        step_back();
         return *this;
     }
 
-    template <typename T = self_type>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::bidirectional_iterator_tag>::value,
-        T
-    >::type operator++(int)
+    self_type operator--(int)
     {
         self_type ret(*this);
-        auto i = 0U;
-        while(i < stride_ && current_ < end_) { ++current_; ++i; }
+        step_back();
         return ret;
     }
-   
-    template <typename T = self_type>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::random_access_iterator_tag>::value,
-        T
-    >::type operator++(int)
+
+    bool equals(self_type other) const
     {
-        self_type ret(*this);
-        if(current_ + stride_ > end_) { current_ = end_; }
-        else { current_ += stride_; }
-        return ret;
+        return current_ == other.current_;
     }
 
-    template <typename T = self_type&>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::bidirectional_iterator_tag>::value,
-        T
-    >::type operator--()
+private:
+
+    void step_forward()
+    {
+        auto i = 0U;
+        while(i < stride_ && current_ != end_) { ++current_; ++i; }
+    }
+
+    void step_back()
     {
         for(auto i = 0U; i < stride_; ++i) {
             --current_;
         }
-        return *this;
     }
 
-    template <typename T = self_type&>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::random_access_iterator_tag>::value,
-        T
-    >::type operator--()
+    // Note: I should use an actual value to keep track of how many
+    // "past" the end I end up, so that operator-- will work correctly
+    // (it currently doesn't).
+    
+    base_iterator   current_;
+    base_iterator   end_;
+    std::size_t     stride_;
+};
+
+//================================================================================
+
+template <typename Range>
+bool operator==(
+    range_stride_iterator<Range> r1, range_stride_iterator<Range> r2
+)
+{
+    return r1.equals(r2);
+}
+
+template <typename Range>
+bool operator!=(
+    range_stride_iterator<Range> r1, range_stride_iterator<Range> r2
+)
+{
+    return !operator==(r1, r2);
+}
+
+//================================================================================
+
+// With random access, a stride refers to element i as the i * stride-th
+// element of the underlying range. Counting i, rather than moving an
+// iterator that clamps to the end, gives loops over a stride a trip count
+// the compiler can work out, so they can be vectorized like hand written
+// strided loops.
+template <typename Range>
+struct range_stride_indexed_iterator
+    : public std::iterator<
+        std::random_access_iterator_tag,
+        typename Range::value_type,
+        difference_type_t<Range>
+      >
+{
+private:
+
+    using range_type    = typename std::remove_reference<Range>::type;
+    using self_type     = range_stride_indexed_iterator<Range>;
+    using base_iterator = typename range_type::iterator;
+
+public:
+
+    using value_type      = typename range_type::value_type;
+    using reference       = decltype(*std::declval<base_iterator&>());
+    using difference_type = difference_type_t<Range>;
+
+    range_stride_indexed_iterator(
+        base_iterator first, difference_type index, std::size_t stride
+    )
+        : first_(first),
+          index_(index),
+          stride_(stride)
+    { }
+
+    reference operator*() const
+    {
+        return *(first_ + offset(index_));
+    }
+
+    reference operator[](difference_type n) const
     {
-        current_ -= stride_;
+        return *(first_ + offset(index_ + n));
+    }
+
+    self_type& operator++()
+    {
+        ++index_;
         return *this;
     }
 
-    template <typename T = self_type>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::bidirectional_iterator_tag>::value,
-        T
-    >::type operator--(int)
+    self_type operator++(int)
     {
         self_type ret(*this);
-        for(auto i = 0U; i < stride_; ++i) {
-            --current_;
-        }
+        ++index_;
         return ret;
     }
 
-    template <typename T = self_type>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::random_access_iterator_tag>::value,
-        T
-    >::type operator--(int)
+    self_type& operator--()
+    {
+        --index_;
+        return *this;
+    }
+
+    self_type operator--(int)
     {
         self_type ret(*this);
-        current_ -= stride_;
+        --index_;
         return ret;
     }
 
-    template <typename T = self_type&>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::random_access_iterator_tag>::value,
-        T
-    >::type operator+(std::size_t n)
+    self_type& operator+=(difference_type n)
     {
-        current_ += (stride_ * n);
+        index_ += n;
         return *this;
     }
 
-    template <typename T = self_type&>
-    typename std::enable_if<
-        std::is_same<iterator_category, std::random_access_iterator_tag>::value,
-        T
-    >::type operator-(std::size_t n)
+    self_type& operator-=(difference_type n)
     {
-        current_ -= (stride_ * n);
+        index_ -= n;
         return *this;
     }
 
-    bool equals(self_type other) const
+    self_type operator+(difference_type n) const
     {
-        return current_ == other.current_;
+        return self_type(first_, index_ + n, stride_);
+    }
+
+    self_type operator-(difference_type n) const
+    {
+        return self_type(first_, index_ - n, stride_);
+    }
+
+    difference_type operator-(const self_type& other) const
+    {
+        return index_ - other.index_;
+    }
+
+    bool equals(const self_type& other) const
+    {
+        return index_ == other.index_;
+    }
+
+    bool less(const self_type& other) const
+    {
+        return index_ < other.index_;
     }
 
 private:
 
-    // Note: I should use an actual value to keep track of how many
-    // "past" the end I end up, so that operator-- and operator-=
-    // will work correctly (they currently don't).
-    
-    base_iterator   current_;
-    base_iterator   end_;
+    // Worked out unsigned: compilers vectorize strided loads over an
+    // unsigned stride, but not over one converted to a signed type.
+    difference_type offset(difference_type index) const
+    {
+        return static_cast<difference_type>(static_cast<std::size_t>(index) * stride_);
+    }
+
+    base_iterator   first_;
+    difference_type index_;
     std::size_t     stride_;
 };
 
-//================================================================================
-
 template <typename Range>
 bool operator==(
-    range_stride_iterator<Range> r1, range_stride_iterator<Range> r2
+    const range_stride_indexed_iterator<Range>& r1, const range_stride_indexed_iterator<Range>& r2
 )
 {
     return r1.equals(r2);
@@ -191,12 +255,53 @@ bool operator==(
 
 template <typename Range>
 bool operator!=(
-    range_stride_iterator<Range> r1, range_stride_iterator<Range> r2
+    const range_stride_indexed_iterator<Range>& r1, const range_stride_indexed_iterator<Range>& r2
 )
 {
     return !operator==(r1, r2);
 }
 
+template <typename Range>
+bool operator<(
+    const range_stride_indexed_iterator<Range>& r1, const range_stride_indexed_iterator<Range>& r2
+)
+{
+    return r1.less(r2);
+}
+
+template <typename Range>
+bool operator>(
+    const range_stride_indexed_iterator<Range>& r1, const range_stride_indexed_iterator<Range>& r2
+)
+{
+    return r2.less(r1);
+}
+
+template <typename Range>
+bool operator<=(
+    const range_stride_indexed_iterator<Range>& r1, const range_stride_indexed_iterator<Range>& r2
+)
+{
+    return !r2.less(r1);
+}
+
+template <typename Range>
+bool operator>=(
+    const range_stride_indexed_iterator<Range>& r1, const range_stride_indexed_iterator<Range>& r2
+)
+{
+    return !r1.less(r2);
+}
+
+template <typename Range>
+range_stride_indexed_iterator<Range> operator+(
+    typename range_stride_indexed_iterator<Range>::difference_type n,
+    const range_stride_indexed_iterator<Range>& r
+)
+{
+    return r + n;
+}
+
 //================================================================================
 
 template <typename Range>
@@ -208,7 +313,11 @@ private:
 
 public:
 
-    using iterator   = range_stride_iterator<range_type>;
+    using iterator   = std::conditional_t<
+        is_random_access<Range>::value,
+        range_stride_indexed_iterator<range_type>,
+        range_stride_iterator<range_type>
+    >;
     using reference  = typename range_type::reference;
     using value_type = typename range_type::value_type;
 
@@ -223,20 +332,68 @@ public:
 
     ~range_stride() = default;
 
+    range_stride(const range_stride& other) = default;
+    range_stride(range_stride&& other) = default;
+
     iterator begin()
     {
-        return iterator(range_.begin(), range_.end(), stride_);
+        return begin(is_random_access<Range>());
     }
 
     iterator end()
     {
-        return iterator(range_.end(), range_.end(), stride_);
+        return end(is_random_access<Range>());
+    }
+
+    // Splitting: element i of a stride lives at position i * stride of the
+    // underlying range, so with random access any [from, to) sub-range is
+    // O(1). Without it, a stride can't be split.
+
+    template <typename R = Range>
+    typename std::enable_if<is_random_access<R>::value, std::size_t>::type
+    split_size()
+    {
+        const auto n = static_cast<std::size_t>(range_.end() - range_.begin());
+        return (n + stride_ - 1) / stride_;
+    }
+
+    template <typename R = Range>
+    typename std::enable_if<is_random_access<R>::value, iterator_range<iterator>>::type
+    split_range(std::size_t from, std::size_t to)
+    {
+        return iterator_range<iterator>(at(from), at(to));
     }
 
 private:
+
+    iterator at(std::size_t i)
+    {
+        using difference_type = typename iterator::difference_type;
+        return iterator(range_.begin(), static_cast<difference_type>(i), stride_);
+    }
+
+    iterator begin(std::true_type)
+    {
+        return at(0);
+    }
+
+    iterator end(std::true_type)
+    {
+        return at(split_size());
+    }
+
+    iterator begin(std::false_type)
+    {
+        return iterator(range_.begin(), range_.end(), stride_);
+    }
+
+    iterator end(std::false_type)
+    {
+        return iterator(range_.end(), range_.end(), stride_);
+    }
     
-    Range&&     range_;
-    std::size_t stride_;    
+    stored_range_t<Range> range_;
+    std::size_t           stride_;    
 };
 
 } // end namespace detail
@@ -259,10 +416,10 @@ detail::range_stride<Range> stride(Range&& c, std::size_t stride)
 
     static_assert(
         std::is_base_of<
-            std::bidirectional_iterator_tag,
+            std::input_iterator_tag,
             typename std::iterator_traits<iterator_type>::iterator_category
         >::value,
-        "Must have at least bidirectional iterators for range stride!"
+        "Must have at least input iterators for range stride!"
     );
 
     return detail::range_stride<Range>(std::forward<Range>(c), stride);
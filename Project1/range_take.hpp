@@ -0,0 +1,430 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace adaptor
+{
+namespace detail
+{
+
+template <typename Range>
+struct range_take;
+
+// Never moves the underlying iterator past the last element taken, so
+// taking from an expensive (or endless) range only ever computes the
+// elements that are actually used. With random access, the count is
+// clamped to the size up front, so it alone marks the end: loops then
+// have a trip count the compiler can work out (and vectorize).
+template <typename Range>
+struct range_take_iterator
+    : public std::iterator<
+        forward_category_t<Range>,
+        value_type_t<Range>,
+        difference_type_t<Range>
+      >
+{
+private:
+
+    using range_type    = typename std::remove_reference<Range>::type;
+    using self_type     = range_take_iterator<Range>;
+    using base_iterator = typename range_type::iterator;
+
+public:
+
+    using reference = decltype(*std::declval<base_iterator&>());
+
+    range_take_iterator(base_iterator where, base_iterator end, std::size_t remaining)
+        : current_(where),
+          end_(end),
+          remaining_(remaining)
+    { }
+
+    reference operator*()
+    {
+        return *current_;
+    }
+
+    self_type& operator++()
+    {
+        step(is_random_access<Range>());
+        return *this;
+    }
+
+    self_type operator++(int)
+    {
+        self_type ret(*this);
+        ++(*this);
+        return ret;
+    }
+
+    bool at_end() const
+    {
+        return remaining_ == 0 || (!is_random_access<Range>::value && current_ == end_);
+    }
+
+    bool equals(const self_type& other) const
+    {
+        return equals(other, is_random_access<Range>());
+    }
+
+private:
+
+    // Moving to the end of the underlying range (one past the last element
+    // taken) is free with random access.
+    void step(std::true_type)
+    {
+        --remaining_;
+        ++current_;
+    }
+
+    void step(std::false_type)
+    {
+        if(--remaining_ != 0) { ++current_; }
+    }
+
+    bool equals(const self_type& other, std::true_type) const
+    {
+        return remaining_ == other.remaining_;
+    }
+
+    bool equals(const self_type& other, std::false_type) const
+    {
+        if(at_end() || other.at_end()) { return at_end() == other.at_end(); }
+        return current_ == other.current_;
+    }
+
+    base_iterator current_;
+    base_iterator end_;
+    std::size_t   remaining_;
+};
+
+template <typename Range>
+bool operator==(const range_take_iterator<Range>& r1, const range_take_iterator<Range>& r2)
+{
+    return r1.equals(r2);
+}
+
+template <typename Range>
+bool operator!=(const range_take_iterator<Range>& r1, const range_take_iterator<Range>& r2)
+{
+    return !operator==(r1, r2);
+}
+
+// The first n elements of a range, or all of them if there are fewer.
+template <typename Range>
+struct range_take
+{
+    using range_type = typename std::remove_reference<Range>::type;
+
+public:
+
+    using iterator   = range_take_iterator<Range>;
+    using value_type = value_type_t<Range>;
+    using reference  = typename iterator::reference;
+
+    range_take(Range&& r, std::size_t n)
+        : range_(std::forward<Range>(r)),
+          n_(n)
+    { }
+
+    iterator begin()
+    {
+        return iterator(range_.begin(), range_.end(), count(is_random_access<Range>()));
+    }
+
+    iterator end()
+    {
+        return iterator(range_.end(), range_.end(), 0);
+    }
+
+private:
+
+    std::size_t count(std::true_type)
+    {
+        return std::min(n_, static_cast<std::size_t>(range_.end() - range_.begin()));
+    }
+
+    std::size_t count(std::false_type)
+    {
+        return n_;
+    }
+
+    stored_range_t<Range> range_;
+    std::size_t           n_;
+};
+
+//================================================================================
+
+template <typename Range, typename Predicate>
+struct range_take_while;
+
+template <typename Range, typename Predicate>
+struct range_take_while_iterator
+    : public std::iterator<
+        forward_category_t<Range>,
+        value_type_t<Range>,
+        difference_type_t<Range>
+      >
+{
+private:
+
+    using range_type            = typename std::remove_reference<Range>::type;
+    using self_type             = range_take_while_iterator<Range, Predicate>;
+    using range_take_while_type = range_take_while<Range, Predicate>;
+    using base_iterator         = typename range_type::iterator;
+
+public:
+
+    using reference = decltype(*std::declval<base_iterator&>());
+
+    range_take_while_iterator(range_take_while_type& r, base_iterator where, base_iterator end)
+        : parent_(std::addressof(r)),
+          current_(where),
+          end_(end),
+          done_(true)
+    {
+        check();
+    }
+
+    reference operator*()
+    {
+        return *current_;
+    }
+
+    self_type& operator++()
+    {
+        ++current_;
+        check();
+        return *this;
+    }
+
+    self_type operator++(int)
+    {
+        self_type ret(*this);
+        ++(*this);
+        return ret;
+    }
+
+    bool equals(const self_type& other) const
+    {
+        if(done_ || other.done_) { return done_ == other.done_; }
+        return current_ == other.current_;
+    }
+
+private:
+
+    void check()
+    {
+        done_ = current_ == end_ || !parent_->func_(*current_);
+    }
+
+    range_take_while_type* parent_;
+    base_iterator          current_;
+    base_iterator          end_;
+    bool                   done_;
+};
+
+template <typename Range, typename Predicate>
+bool operator==(
+    const range_take_while_iterator<Range, Predicate>& r1,
+    const range_take_while_iterator<Range, Predicate>& r2
+)
+{
+    return r1.equals(r2);
+}
+
+template <typename Range, typename Predicate>
+bool operator!=(
+    const range_take_while_iterator<Range, Predicate>& r1,
+    const range_take_while_iterator<Range, Predicate>& r2
+)
+{
+    return !operator==(r1, r2);
+}
+
+// The elements of a range up to (not including) the first one that
+// doesn't satisfy the predicate. Nothing after that is looked at.
+template <typename Range, typename Predicate>
+struct range_take_while
+{
+    friend struct range_take_while_iterator<Range, Predicate>;
+
+    using range_type = typename std::remove_reference<Range>::type;
+
+public:
+
+    using iterator   = range_take_while_iterator<Range, Predicate>;
+    using value_type = value_type_t<Range>;
+    using reference  = typename iterator::reference;
+
+    range_take_while(Range&& r, Predicate func)
+        : range_(std::forward<Range>(r)),
+          func_(std::move(func))
+    { }
+
+    iterator begin()
+    {
+        return iterator(*this, range_.begin(), range_.end());
+    }
+
+    iterator end()
+    {
+        return iterator(*this, range_.end(), range_.end());
+    }
+
+private:
+
+    stored_range_t<Range> range_;
+    Predicate             func_;
+};
+
+//================================================================================
+
+// The elements of a range from the first one that doesn't satisfy the
+// predicate on. Only begin() does any work, so the iterators are those of
+// the underlying range, with everything they support (random access etc.).
+template <typename Range, typename Predicate>
+struct range_drop_while
+{
+    using range_type = typename std::remove_reference<Range>::type;
+
+public:
+
+    using iterator   = typename range_type::iterator;
+    using value_type = value_type_t<Range>;
+    using reference  = decltype(*std::declval<iterator&>());
+
+    range_drop_while(Range&& r, Predicate func)
+        : range_(std::forward<Range>(r)),
+          func_(std::move(func))
+    { }
+
+    iterator begin()
+    {
+        auto first = range_.begin();
+        auto last  = range_.end();
+        while(first != last && func_(*first)) { ++first; }
+        return first;
+    }
+
+    iterator end()
+    {
+        return range_.end();
+    }
+
+private:
+
+    stored_range_t<Range> range_;
+    Predicate             func_;
+};
+
+//================================================================================
+
+struct inner_take
+{
+    std::size_t n_;
+
+    inner_take(std::size_t n)
+        : n_(n)
+    { }
+
+    template <typename Range>
+    auto operator()(Range&& r)
+    {
+        return detail::range_take<Range>(std::forward<Range>(r), n_);
+    }
+};
+
+template <typename Predicate>
+struct inner_take_while
+{
+    Predicate p_;
+
+    inner_take_while(Predicate p)
+        : p_(std::move(p))
+    { }
+
+    template <typename Range>
+    auto operator()(Range&& r) &
+    {
+        return detail::range_take_while<Range, Predicate>(std::forward<Range>(r), p_);
+    }
+
+    template <typename Range>
+    auto operator()(Range&& r) &&
+    {
+        return detail::range_take_while<Range, Predicate>(
+            std::forward<Range>(r), std::move(p_)
+        );
+    }
+};
+
+template <typename Predicate>
+struct inner_drop_while
+{
+    Predicate p_;
+
+    inner_drop_while(Predicate p)
+        : p_(std::move(p))
+    { }
+
+    template <typename Range>
+    auto operator()(Range&& r) &
+    {
+        return detail::range_drop_while<Range, Predicate>(std::forward<Range>(r), p_);
+    }
+
+    template <typename Range>
+    auto operator()(Range&& r) &&
+    {
+        return detail::range_drop_while<Range, Predicate>(
+            std::forward<Range>(r), std::move(p_)
+        );
+    }
+};
+
+} // end namespace detail
+
+inline detail::inner_take take(std::size_t n)
+{
+    return detail::inner_take(n);
+}
+
+template <typename Predicate>
+detail::inner_take_while<Predicate> take_while(Predicate p)
+{
+    return detail::inner_take_while<Predicate>(std::move(p));
+}
+
+template <typename Predicate>
+detail::inner_drop_while<Predicate> drop_while(Predicate p)
+{
+    return detail::inner_drop_while<Predicate>(std::move(p));
+}
+
+template <typename Range>
+auto operator|(Range&& c, detail::inner_take inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+template <typename Range, typename Predicate>
+auto operator|(Range&& c, detail::inner_take_while<Predicate> inner)
+{
+    return std::move(inner)(std::forward<Range>(c));
+}
+
+template <typename Range, typename Predicate>
+auto operator|(Range&& c, detail::inner_drop_while<Predicate> inner)
+{
+    return std::move(inner)(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
@@ -0,0 +1,177 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+#include "range_split.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace adaptor
+{
+namespace detail
+{
+
+// Keeps the best k values seen so far as a heap, with the worst of them at
+// the front. Anything that isn't better than the front is rejected with a
+// single comparison, so once the heap has warmed up most elements never
+// touch it.
+template <typename T, typename Compare>
+struct bounded_heap
+{
+    bounded_heap(std::size_t k, Compare cmp)
+        : k_(k),
+          cmp_(cmp)
+    {
+        heap_.reserve(k_);
+    }
+
+    void push(const T& value)
+    {
+        if(heap_.size() < k_) {
+            heap_.push_back(value);
+            std::push_heap(heap_.begin(), heap_.end(), cmp_);
+        }
+        else if(k_ != 0 && cmp_(value, heap_.front())) {
+            std::pop_heap(heap_.begin(), heap_.end(), cmp_);
+            heap_.back() = value;
+            std::push_heap(heap_.begin(), heap_.end(), cmp_);
+        }
+    }
+
+    void merge(const bounded_heap& other)
+    {
+        for(const auto& value : other.heap_) {
+            push(value);
+        }
+    }
+
+    std::vector<T> sorted() &&
+    {
+        std::sort_heap(heap_.begin(), heap_.end(), cmp_);
+        return std::move(heap_);
+    }
+
+private:
+
+    std::size_t    k_;
+    Compare        cmp_;
+    std::vector<T> heap_;
+};
+
+template <typename Range, typename Compare>
+bounded_heap<value_type_t<Range>, Compare>
+top_k_of(Range&& r, std::size_t k, Compare cmp)
+{
+    bounded_heap<value_type_t<Range>, Compare> heap(k, cmp);
+    for(auto&& value : r) {
+        heap.push(value);
+    }
+    return heap;
+}
+
+template <typename Compare>
+struct inner_top_k
+{
+    std::size_t k_;
+    Compare     cmp_;
+
+    inner_top_k(std::size_t k, Compare cmp)
+        : k_(k),
+          cmp_(cmp)
+    { }
+
+    template <typename Range>
+    std::vector<value_type_t<Range>> operator()(Range&& r)
+    {
+        return top_k_of(std::forward<Range>(r), k_, cmp_).sorted();
+    }
+};
+
+template <typename Compare>
+struct inner_top_k_parallel
+{
+    std::size_t k_;
+    Compare     cmp_;
+    std::size_t threads_;
+
+    inner_top_k_parallel(std::size_t k, Compare cmp, std::size_t threads)
+        : k_(k),
+          cmp_(cmp),
+          threads_(threads)
+    { }
+
+    template <typename Range>
+    std::vector<value_type_t<Range>> operator()(Range&& r)
+    {
+        static_assert(
+            is_splittable<Range>::value,
+            "Range must be splittable (see range_split.hpp) for top_k_parallel!"
+        );
+
+        using heap_type = bounded_heap<value_type_t<Range>, Compare>;
+
+        auto pieces = adaptor::split(r, threads_);
+        std::vector<std::future<heap_type>> partials;
+        partials.reserve(pieces.size());
+
+        // The first piece is done on the calling thread.
+        for(std::size_t i = 1; i < pieces.size(); ++i) {
+            auto& piece = pieces[i];
+            auto k      = k_;
+            auto cmp    = cmp_;
+            partials.push_back(std::async(std::launch::async, [&piece, k, cmp]() {
+                return top_k_of(piece, k, cmp);
+            }));
+        }
+
+        auto heap = top_k_of(pieces.front(), k_, cmp_);
+        for(auto& partial : partials) {
+            heap.merge(partial.get());
+        }
+        return std::move(heap).sorted();
+    }
+};
+
+} // end namespace detail
+
+// The best k elements of a range, ordered as std::sort(cmp) would order
+// them (so by default, the k largest in descending order). Only k elements
+// are ever held in memory.
+template <typename Compare = std::greater<>>
+detail::inner_top_k<Compare> top_k(std::size_t k, Compare cmp = Compare())
+{
+    return detail::inner_top_k<Compare>(k, cmp);
+}
+
+// As top_k, but the range is split into pieces (see range_split.hpp) that
+// are scanned on separate threads, and the per-thread heaps are merged at
+// the end. cmp is copied into each thread, but the functions of the stages
+// in the pipeline are shared between them.
+template <typename Compare = std::greater<>>
+detail::inner_top_k_parallel<Compare> top_k_parallel(
+    std::size_t k, Compare cmp = Compare(),
+    std::size_t threads = std::thread::hardware_concurrency()
+)
+{
+    return detail::inner_top_k_parallel<Compare>(
+        k, cmp, std::max<std::size_t>(threads, 1)
+    );
+}
+
+template <typename Range, typename Compare>
+auto operator|(Range&& c, detail::inner_top_k<Compare> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+template <typename Range, typename Compare>
+auto operator|(Range&& c, detail::inner_top_k_parallel<Compare> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
@@ -17,7 +17,7 @@ struct range_unique;
 template <typename Range>
 struct range_unique_iterator
     : public std::iterator<
-        std::forward_iterator_tag,
+        forward_category_t<Range>,
         typename Range::value_type
       >
 {
@@ -31,7 +31,7 @@ public:
 
     using value_type        = typename range_type::value_type;
     using reference         = value_type&;
-    using iterator_category = iterator_category_t<Range>;
+    using iterator_category = forward_category_t<Range>;
 
     range_unique_iterator(base_iterator where, base_iterator end)
         : current_(where),
@@ -51,19 +51,14 @@ public:
     self_type& operator++()
     {
         if(current_ == end_) { return *this; }
-        const value_type& value = *current_;
-        ++current_;
-        while(current_ != end_ && value == *current_) { ++current_; }
+        skip_run(iterator_category());
         return *this;
     }
 
     self_type operator++(int)
     {
         self_type ret(*this);
-        if(current_ == end_) { return ret; }
-        const value_type& value = *current_;
-        ++current_;
-        while(current_ != end_ && value == *current_) { ++current_; }
+        ++(*this);
         return ret;
     }
    
@@ -74,6 +69,24 @@ public:
 
 private:
 
+    // Forward iterators leave the previous element where it is, so the run
+    // can be compared against it by reference.
+    void skip_run(std::forward_iterator_tag)
+    {
+        const value_type& value = *current_;
+        ++current_;
+        while(current_ != end_ && value == *current_) { ++current_; }
+    }
+
+    // Single pass iterators (e.g. a generator) may overwrite the previous
+    // element when incremented, so it has to be copied.
+    void skip_run(std::input_iterator_tag)
+    {
+        const value_type value = *current_;
+        ++current_;
+        while(current_ != end_ && value == *current_) { ++current_; }
+    }
+
     base_iterator current_;
     base_iterator end_;
 };
@@ -103,7 +116,8 @@ struct range_unique
 {
 private:
 
-    using range_type = typename std::remove_reference_t<Range>;
+    using range_type    = typename std::remove_reference_t<Range>;
+    using base_iterator = typename range_type::iterator;
 
 public:
 
@@ -130,11 +144,52 @@ public:
         return iterator(range_.end(), range_.end());
     }
 
+    // Splitting: the number of unique elements isn't known up front, so a
+    // unique range is split on positions in the underlying range instead.
+    // Each cut point is moved forward past the run it lands in, so a run is
+    // never reported by two neighbouring pieces. Only available when the
+    // underlying range can be cut (see is_position_splittable).
+
+    template <typename R = Range>
+    typename std::enable_if<is_position_splittable<R>::value, std::size_t>::type
+    split_size()
+    {
+        return static_cast<std::size_t>(
+            std::distance(range_.begin(), range_.end())
+        );
+    }
+
+    template <typename R = Range>
+    typename std::enable_if<is_position_splittable<R>::value, iterator_range<iterator>>::type
+    split_range(std::size_t from, std::size_t to)
+    {
+        auto first = cut_point(from);
+        auto last  = cut_point(to);
+        return iterator_range<iterator>(iterator(first, last), iterator(last, last));
+    }
+
 private:
+
+    base_iterator cut_point(std::size_t n)
+    {
+        using difference_type = difference_type_t<Range>;
+        auto begin = range_.begin();
+        auto end   = range_.end();
+        if(n == 0) { return begin; }
+        auto prev = std::next(begin, static_cast<difference_type>(n) - 1);
+        auto cut  = std::next(prev);
+        while(cut != end && *prev == *cut) { ++prev; ++cut; }
+        return cut;
+    }
     
-    Range&& range_;
+    stored_range_t<Range> range_;
 };
 
+template <typename Range>
+struct is_order_dependent<range_unique<Range>>
+    : std::true_type
+{ };
+
 } // end namespace detail
 
 auto unique()
@@ -0,0 +1,411 @@
+#pragma once
+
+#include "iterator_helpers.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <charconv>
+#endif
+
+namespace adaptor
+{
+
+enum class write_format
+{
+    binary,     // the bytes of each element, back to back
+    text        // each element formatted as text, followed by a delimiter
+};
+
+struct write_options
+{
+    char        delimiter   = '\n';         // after each element, for text
+    bool        background  = false;        // write on another thread
+    std::size_t buffer_size = 1 << 20;      // bytes per write
+};
+
+struct write_stats
+{
+    std::size_t elements;
+    std::size_t bytes;
+    double      seconds;
+
+    double bytes_per_second() const
+    {
+        return seconds > 0 ? static_cast<double>(bytes) / seconds : 0.0;
+    }
+};
+
+namespace detail
+{
+
+// Formats value into out, returning the end of what was written. out must
+// have room for max_formatted_size characters.
+
+constexpr std::size_t max_formatted_size = 32;
+
+template <typename T>
+typename std::enable_if<std::is_integral<T>::value, char*>::type
+format_value(T value, char* out)
+{
+    // Two digits at a time, from the back.
+    static constexpr char pairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    using unsigned_type = std::make_unsigned_t<
+        std::conditional_t<std::is_same<T, bool>::value, unsigned char, T>
+    >;
+
+    unsigned_type n = static_cast<unsigned_type>(value);
+    if(std::is_signed<T>::value && value < T(0)) {
+        *out++ = '-';
+        n = static_cast<unsigned_type>(unsigned_type(0) - n);
+    }
+
+    char  digits[std::numeric_limits<unsigned_type>::digits10 + 1];
+    char* first = digits + sizeof(digits);
+    while(n >= 100) {
+        const auto pair = static_cast<std::size_t>(n % 100) * 2;
+        n /= 100;
+        *--first = pairs[pair + 1];
+        *--first = pairs[pair];
+    }
+    if(n >= 10) {
+        const auto pair = static_cast<std::size_t>(n) * 2;
+        *--first = pairs[pair + 1];
+        *--first = pairs[pair];
+    }
+    else {
+        *--first = static_cast<char>('0' + n);
+    }
+
+    const auto length = static_cast<std::size_t>(digits + sizeof(digits) - first);
+    std::memcpy(out, first, length);
+    return out + length;
+}
+
+// The shortest text that reads back as the same value where std::to_chars
+// supports floating point, otherwise 17 significant digits (which also
+// reads back as the same value, but is slower to produce).
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, char*>::type
+format_value(T value, char* out)
+{
+#if defined(__cpp_lib_to_chars)
+    return std::to_chars(out, out + max_formatted_size, value).ptr;
+#else
+    const int length = std::snprintf(
+        out, max_formatted_size, "%.*g", std::numeric_limits<T>::max_digits10,
+        static_cast<double>(value)
+    );
+    return out + length;
+#endif
+}
+
+//================================================================================
+
+// Collects output into large blocks, aligned to 4KB, and writes them one at
+// a time. In the background, the next block is filled while the previous
+// one is being written.
+struct block_writer
+{
+    static constexpr std::size_t alignment = 4096;
+
+    block_writer(std::FILE* file, const write_options& options)
+        : file_(file),
+          background_(options.background),
+          size_(std::max<std::size_t>(options.buffer_size, 2 * max_formatted_size)),
+          current_(0),
+          used_(0),
+          bytes_(0)
+    {
+        for(auto& block : storage_) {
+            block.resize(size_ + alignment);
+        }
+        for(std::size_t i = 0; i < 2; ++i) {
+            void*       p     = storage_[i].data();
+            std::size_t space = storage_[i].size();
+            blocks_[i] = static_cast<char*>(std::align(alignment, size_, p, space));
+        }
+    }
+
+    // Waits for a background write, if there is one, before the blocks go.
+    ~block_writer()
+    {
+        if(pending_.valid()) { pending_.wait(); }
+    }
+
+    void write(const char* data, std::size_t size)
+    {
+        while(size != 0) {
+            const auto n = std::min(size, size_ - used_);
+            std::memcpy(blocks_[current_] + used_, data, n);
+            used_ += n;
+            data  += n;
+            size  -= n;
+            if(used_ == size_) { flush(); }
+        }
+    }
+
+    // Room for n (at most max_formatted_size) bytes at the end of the
+    // current block, to be filled and then committed.
+    char* reserve(std::size_t n)
+    {
+        if(size_ - used_ < n) { flush(); }
+        return blocks_[current_] + used_;
+    }
+
+    void commit(char* end)
+    {
+        used_ = static_cast<std::size_t>(end - blocks_[current_]);
+    }
+
+    // Writes large contiguous data directly, without copying it.
+    void write_through(const char* data, std::size_t size)
+    {
+        flush();
+        wait();
+        write_block(data, size);
+    }
+
+    std::size_t finish()
+    {
+        flush();
+        wait();
+        if(std::fflush(file_) != 0) {
+            throw std::runtime_error("Could not write to file!");
+        }
+        return bytes_;
+    }
+
+private:
+
+    void flush()
+    {
+        if(used_ == 0) { return; }
+
+        const char*       data = blocks_[current_];
+        const std::size_t size = used_;
+
+        if(background_) {
+            wait();
+            pending_ = std::async(std::launch::async, [this, data, size]() {
+                write_block(data, size);
+            });
+            current_ = 1 - current_;
+        }
+        else {
+            write_block(data, size);
+        }
+        used_ = 0;
+    }
+
+    void wait()
+    {
+        if(pending_.valid()) { pending_.get(); }
+    }
+
+    void write_block(const char* data, std::size_t size)
+    {
+        if(std::fwrite(data, 1, size, file_) != size) {
+            throw std::runtime_error("Could not write to file!");
+        }
+        bytes_ += size;
+    }
+
+    std::FILE*        file_;
+    bool              background_;
+    std::size_t       size_;
+    std::vector<char> storage_[2];
+    char*             blocks_[2];
+    std::size_t       current_;
+    std::size_t       used_;
+    std::size_t       bytes_;
+    std::future<void> pending_;
+};
+
+struct file_closer
+{
+    void operator()(std::FILE* file) const
+    {
+        std::fclose(file);
+    }
+};
+
+// The format is a template parameter, so elements that cannot be written
+// in it are rejected when the pipeline is built, not when it runs.
+template <write_format Format>
+struct inner_write_to
+{
+    std::string   path_;
+    std::FILE*    file_;
+    write_options options_;
+
+    inner_write_to(std::string path, std::FILE* file, write_options options)
+        : path_(std::move(path)),
+          file_(file),
+          options_(options)
+    { }
+
+    template <typename Range>
+    write_stats operator()(Range&& r)
+    {
+        using value_type = value_type_t<Range>;
+        using is_text    = std::integral_constant<bool, Format == write_format::text>;
+
+        static_assert(
+            is_text::value || std::is_trivially_copyable<value_type>::value,
+            "Must have trivially copyable elements for binary write_to!"
+        );
+        static_assert(
+            !is_text::value || std::is_arithmetic<value_type>::value,
+            "Must have integral or floating point elements for text write_to!"
+        );
+
+        const auto start = std::chrono::steady_clock::now();
+
+        // Files opened here are written unbuffered: the blocks are the buffer.
+        std::unique_ptr<std::FILE, file_closer> owned;
+        auto* file = file_;
+        if(file == nullptr) {
+            owned.reset(std::fopen(path_.c_str(), "wb"));
+            if(!owned) {
+                throw std::runtime_error("Could not open " + path_ + " for writing!");
+            }
+            file = owned.get();
+            std::setvbuf(file, nullptr, _IONBF, 0);
+        }
+
+        block_writer writer(file, options_);
+        const auto elements = write(r, writer, is_text());
+
+        const auto bytes = writer.finish();
+        if(owned && std::fclose(owned.release()) != 0) {
+            throw std::runtime_error("Could not write to " + path_ + "!");
+        }
+
+        const std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        return write_stats{ elements, bytes, seconds.count() };
+    }
+
+private:
+
+    // Binary.
+    template <typename Range>
+    std::size_t write(Range& r, block_writer& writer, std::false_type)
+    {
+        return write_binary(r, writer, is_contiguous<Range>());
+    }
+
+    template <typename Range>
+    std::size_t write_binary(Range& r, block_writer& writer, std::true_type)
+    {
+        const auto n = static_cast<std::size_t>(r.end() - r.begin());
+        writer.write_through(reinterpret_cast<const char*>(r.data()), n * sizeof(*r.data()));
+        return n;
+    }
+
+    // Elements that fit are copied straight into the current block, as
+    // text is; larger ones go through write().
+    template <typename Range>
+    std::size_t write_binary(Range& r, block_writer& writer, std::false_type)
+    {
+        using value_type = value_type_t<Range>;
+        using fits = std::integral_constant<bool, sizeof(value_type) <= max_formatted_size>;
+
+        std::size_t n = 0;
+        for(auto&& value : r) {
+            const value_type copy = value;
+            write_element(copy, writer, fits());
+            ++n;
+        }
+        return n;
+    }
+
+    template <typename T>
+    static void write_element(const T& value, block_writer& writer, std::true_type)
+    {
+        char* out = writer.reserve(sizeof(T));
+        std::memcpy(out, &value, sizeof(T));
+        writer.commit(out + sizeof(T));
+    }
+
+    template <typename T>
+    static void write_element(const T& value, block_writer& writer, std::false_type)
+    {
+        writer.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    // Text.
+    template <typename Range>
+    std::size_t write(Range& r, block_writer& writer, std::true_type)
+    {
+        std::size_t n = 0;
+        for(auto&& value : r) {
+            char* out = format_value(value_type_t<Range>(value), writer.reserve(max_formatted_size + 1));
+            *out++ = options_.delimiter;
+            writer.commit(out);
+            ++n;
+        }
+        return n;
+    }
+};
+
+} // end namespace detail
+
+// Writes the elements of a range to a file, returning how much was written
+// and how long it took. Binary output needs trivially copyable elements
+// and writes their bytes as they are (contiguous ranges in one go); text
+// output needs integral or floating point elements, and other elements
+// fail to compile. Output is gathered into buffer_size blocks; with
+// background set, each block is written on another thread while the next
+// one is filled.
+//
+//     r | write_to("out.bin");
+//     r | write_to<write_format::text>(stdout, write_options{ ' ' });
+//
+// The file is created (or truncated) when the pipeline runs.
+template <write_format Format = write_format::binary>
+detail::inner_write_to<Format> write_to(
+    const std::string& path, write_options options = write_options()
+)
+{
+    return detail::inner_write_to<Format>(path, nullptr, options);
+}
+
+// As above, to a file that is already open (e.g. stdout). It is flushed,
+// but not closed, at the end.
+template <write_format Format = write_format::binary>
+detail::inner_write_to<Format> write_to(
+    std::FILE* file, write_options options = write_options()
+)
+{
+    if(file == nullptr) {
+        throw std::invalid_argument("File must not be null!");
+    }
+
+    return detail::inner_write_to<Format>(std::string(), file, options);
+}
+
+template <typename Range, write_format Format>
+write_stats operator|(Range&& c, detail::inner_write_to<Format> inner)
+{
+    return inner(std::forward<Range>(c));
+}
+
+} // end namespace adaptor
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+// Minimal timing for the benchmarks: the best of a few runs, so one slow
+// run (a page fault storm, another process) doesn't skew the result.
+
+template <typename Func>
+double best_seconds(int runs, Func&& func)
+{
+    double best = 1e300;
+    for(int i = 0; i < runs; ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        func();
+        const std::chrono::duration<double> took = std::chrono::steady_clock::now() - start;
+        best = std::min(best, took.count());
+    }
+    return best;
+}
+
+// Keeps a result alive so the work producing it isn't optimized away.
+template <typename T>
+void keep(const T& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+inline void report(const char* name, double seconds, double elements)
+{
+    std::printf("%-34s %9.3f ms %8.3f ns/element\n", name, seconds * 1e3, seconds * 1e9 / elements);
+}
+
+inline void report_bytes(const char* name, double seconds, double bytes)
+{
+    std::printf("%-34s %9.3f ms %8.1f MB/s\n", name, seconds * 1e3, bytes / seconds / 1e6);
+}
@@ -0,0 +1,49 @@
+// compact_into after a filter against push_back from the filter iterator,
+// over random ints with half of them kept. Built three times: for the
+// default target, and for AVX2 and AVX-512 where the compiler has them.
+
+#include "bench.hpp"
+
+#include "range_compact.hpp"
+#include "range_filter.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace adaptor;
+
+int main()
+{
+    const std::size_t n = 50000000;
+    std::vector<int> x(n);
+    std::uint32_t seed = 1;
+    for(auto& v : x) {
+        seed = seed * 1664525u + 1013904223u;
+        v = static_cast<int>(seed >> 8);
+    }
+
+    auto odd = [](int v) { return (v & 1) != 0; };
+
+    std::vector<int> out;
+    out.reserve(n);
+
+#if defined(__AVX512F__)
+    std::printf("%zu ints, 50%% kept (AVX-512):\n", n);
+#elif defined(__AVX2__)
+    std::printf("%zu ints, 50%% kept (AVX2):\n", n);
+#else
+    std::printf("%zu ints, 50%% kept:\n", n);
+#endif
+
+    report("range_filter_iterator push_back", best_seconds(5, [&]() {
+        out.clear();
+        for(auto v : x | filter(odd)) { out.push_back(v); }
+        keep(out.data());
+    }), n);
+
+    report("compact_into", best_seconds(5, [&]() {
+        out.clear();
+        x | filter(odd) | compact_into(out);
+        keep(out.data());
+    }), n);
+}
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Build-time benchmark for deep adaptor pipelines.
+
+Generates one translation unit per pipeline family and depth (1-16 stages
+by default), compiles each, and records:
+
+  - compile time (best of --repeat runs, at --flags),
+  - instantiated functions: functions emitted by an -O0 build, other than
+    the benchmark function itself. At -O0 nothing is inlined, so this is one
+    per instantiated member or function template that is used,
+  - .text size of the object at --flags.
+
+With --baseline (a CSV written by an earlier --output), instantiations and
+.text size are compared, and the script fails if any grows by more than
+--tolerance percent. Compile time is reported but not checked (too noisy).
+"""
+
+import argparse
+import csv
+import os
+import subprocess
+import sys
+import tempfile
+import time
+
+# Stages cycled through to build a pipeline of a given depth. Each family
+# only uses stages that accept the output of the others in it.
+FAMILIES = {
+    # Random access all the way down.
+    "random_access": [
+        "map([](int v) {{ return v + {i}; }})",
+        "stride({s})",
+        "reverse()",
+        "slice(0, 1u << 20)",
+    ],
+    # Forward (or bidirectional) stages.
+    "forward": [
+        "map([](int v) {{ return v * {s}; }})",
+        "filter([](int v) {{ return v != {i}; }})",
+        "unique()",
+        "take_while([](int v) {{ return v < 1000000 + {i}; }})",
+        "drop_while([](int v) {{ return v < {i}; }})",
+        "take(1u << 20)",
+    ],
+}
+
+HEADERS = [
+    "range_copy.hpp",
+    "range_filter.hpp",
+    "range_map.hpp",
+    "range_reverse.hpp",
+    "range_stride.hpp",
+    "range_take.hpp",
+    "range_unique.hpp",
+]
+
+
+def source(family, depth):
+    stages = FAMILIES[family]
+    chain = " | ".join(
+        stages[k % len(stages)].format(i=k, s=k % 3 + 1) for k in range(depth)
+    )
+    lines = ['#include "{}"'.format(h) for h in HEADERS]
+    lines += [
+        "#include <vector>",
+        "using namespace adaptor;",
+        "long run(std::vector<int>& x)",
+        "{",
+        "    long sum = 0;",
+        "    for(auto v : x | {}) {{ sum += v; }}".format(chain),
+        "    return sum;",
+        "}",
+    ]
+    return "\n".join(lines) + "\n"
+
+
+def compile_once(args, path, obj, flags):
+    cmd = [args.compiler] + flags + ["-I", args.include, "-c", path, "-o", obj]
+    start = time.perf_counter()
+    subprocess.run(cmd, check=True)
+    return time.perf_counter() - start
+
+
+def text_size(obj):
+    out = subprocess.run(["size", "-A", obj], check=True, capture_output=True, text=True).stdout
+    return sum(int(line.split()[1]) for line in out.splitlines() if line.startswith(".text"))
+
+
+def emitted_functions(obj):
+    out = subprocess.run(["nm", "--defined-only", obj], check=True, capture_output=True, text=True).stdout
+    kinds = [line.split()[1] for line in out.splitlines() if len(line.split()) == 3]
+    return sum(1 for kind in kinds if kind in "TtWw") - 1
+
+
+def measure(args, workdir, family, depth):
+    path = os.path.join(workdir, "{}_{}.cpp".format(family, depth))
+    obj = path[:-4] + ".o"
+    with open(path, "w") as f:
+        f.write(source(family, depth))
+
+    flags = args.flags.split()
+    seconds = min(compile_once(args, path, obj, flags) for _ in range(args.repeat))
+    size = text_size(obj)
+    compile_once(args, path, obj, [f for f in flags if not f.startswith("-O")] + ["-O0"])
+    return {
+        "family": family,
+        "depth": depth,
+        "seconds": round(seconds, 3),
+        "instantiations": emitted_functions(obj),
+        "text_bytes": size,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--compiler", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--include", required=True, help="directory holding the headers")
+    parser.add_argument("--flags", default="-std=c++14 -O2 -w")
+    parser.add_argument("--max-depth", type=int, default=16)
+    parser.add_argument("--repeat", type=int, default=3)
+    parser.add_argument("--output", help="CSV file to write the results to")
+    parser.add_argument("--baseline", help="CSV file of earlier results to compare against")
+    parser.add_argument("--tolerance", type=float, default=5.0, help="allowed growth, in percent")
+    args = parser.parse_args()
+
+    results = []
+    with tempfile.TemporaryDirectory() as workdir:
+        for family in FAMILIES:
+            for depth in range(1, args.max_depth + 1):
+                results.append(measure(args, workdir, family, depth))
+
+    baseline = {}
+    if args.baseline:
+        with open(args.baseline) as f:
+            for row in csv.DictReader(f):
+                baseline[(row["family"], int(row["depth"]))] = row
+
+    print("{:<14} {:>5} {:>9} {:>15} {:>11}".format("family", "depth", "seconds", "instantiations", ".text"))
+    failed = False
+    for r in results:
+        line = "{:<14} {:>5} {:>9.3f} {:>15} {:>11}".format(
+            r["family"], r["depth"], r["seconds"], r["instantiations"], r["text_bytes"]
+        )
+        old = baseline.get((r["family"], r["depth"]))
+        if old:
+            for key in ("instantiations", "text_bytes"):
+                before = int(old[key])
+                limit = before * (1 + args.tolerance / 100)
+                if r[key] > limit:
+                    line += "  {} grew from {}".format(key, before)
+                    failed = True
+        print(line)
+
+    if args.output:
+        with open(args.output, "w", newline="") as f:
+            writer = csv.DictWriter(f, fieldnames=list(results[0].keys()))
+            writer.writeheader()
+            writer.writerows(results)
+
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,62 @@
+// flat_map over records holding a vector each, against the nested loops
+// it replaces: summing the inner elements, and collecting them.
+
+#include "bench.hpp"
+
+#include "range_collect.hpp"
+#include "range_flatten.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace adaptor;
+
+struct record
+{
+    int              id;
+    std::vector<int> values;
+};
+
+int main()
+{
+    std::vector<record> records(200000);
+    std::uint32_t seed = 1;
+    std::size_t   n    = 0;
+    for(std::size_t r = 0; r < records.size(); ++r) {
+        seed = seed * 1664525u + 1013904223u;
+        records[r].id = static_cast<int>(r);
+        records[r].values.resize((seed >> 8) % 64);
+        for(auto& v : records[r].values) { v = static_cast<int>(n++); }
+    }
+
+    auto values = [](const record& r) -> const std::vector<int>& { return r.values; };
+
+    std::printf("%zu records, %zu ints:\n", records.size(), n);
+
+    report("sum: nested loops", best_seconds(5, [&]() {
+        long sum = 0;
+        for(const auto& r : records) {
+            for(auto v : r.values) { sum += v; }
+        }
+        keep(sum);
+    }), n);
+
+    report("sum: flat_map", best_seconds(5, [&]() {
+        long sum = 0;
+        for(auto v : records | flat_map(values)) { sum += v; }
+        keep(sum);
+    }), n);
+
+    report("collect: nested push_back", best_seconds(5, [&]() {
+        std::vector<int> out;
+        for(const auto& r : records) {
+            for(auto v : r.values) { out.push_back(v); }
+        }
+        keep(out.data());
+    }), n);
+
+    report("collect: flat_map | collect", best_seconds(5, [&]() {
+        auto out = records | flat_map(values) | collect();
+        keep(out.data());
+    }), n);
+}
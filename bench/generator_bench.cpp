@@ -0,0 +1,83 @@
+// Per-element cost of a coroutine generator source against a vector, and
+// what running a slow producer on its own thread buys.
+
+#include "bench.hpp"
+
+#include "range_generator.hpp"
+#include "range_map.hpp"
+#include "range_pipeline_parallel.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using namespace adaptor;
+
+generator<int> numbers(int n)
+{
+    for(int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+}
+
+// Stands in for a producer waiting on I/O: a pause every block.
+generator<int> slow_numbers(int n, int block)
+{
+    for(int i = 0; i < n; ++i) {
+        if(i % block == 0) { std::this_thread::sleep_for(std::chrono::microseconds(200)); }
+        co_yield i;
+    }
+}
+
+// Some work per element for the consumer.
+long consume(long sum, int v)
+{
+    for(int i = 0; i < 20; ++i) { sum = sum * 31 + v + i; }
+    return sum;
+}
+
+int main()
+{
+    const int n = 50000000;
+    std::vector<int> x(n);
+    for(int i = 0; i < n; ++i) { x[i] = i; }
+
+    auto twice = [](int v) { return v * 2; };
+
+    std::printf("%d elements through map:\n", n);
+
+    report("vector", best_seconds(5, [&]() {
+        long sum = 0;
+        for(auto v : x | map(twice)) { sum += v; }
+        keep(sum);
+    }), n);
+
+    report("generator", best_seconds(5, [&]() {
+        long sum = 0;
+        for(auto v : numbers(n) | map(twice)) { sum += v; }
+        keep(sum);
+    }), n);
+
+    report("generator | pipeline_parallel", best_seconds(5, [&]() {
+        long sum = 0;
+        for(auto v : numbers(n) | pipeline_parallel() | map(twice)) { sum += v; }
+        keep(sum);
+    }), n);
+
+    const int m = 2000000;
+    const int block = 4096;
+    std::printf("\n%d elements, producer pausing 200us every %d:\n", m, block);
+
+    report("generator", best_seconds(3, [&]() {
+        long sum = 0;
+        for(auto v : slow_numbers(m, block)) { sum = consume(sum, v); }
+        keep(sum);
+    }), m);
+
+    report("generator | pipeline_parallel", best_seconds(3, [&]() {
+        long sum = 0;
+        for(auto v : slow_numbers(m, block) | pipeline_parallel(block)) { sum = consume(sum, v); }
+        keep(sum);
+    }), m);
+}
@@ -0,0 +1,79 @@
+// map_lut against map over 8 and 16 bit elements, for a cheap function
+// and for one that costs something per call, iterated and collected.
+
+#include "bench.hpp"
+
+#include "range_collect.hpp"
+#include "range_map.hpp"
+#include "range_map_lut.hpp"
+
+#include <cstdint>
+#include <vector>
+
+using namespace adaptor;
+
+int main()
+{
+    const std::size_t n = 16 << 20;
+    std::vector<std::uint8_t>  bytes(n);
+    std::vector<std::uint16_t> words(n);
+    std::uint32_t seed = 1;
+    for(std::size_t i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        bytes[i] = static_cast<std::uint8_t>(seed >> 24);
+        words[i] = static_cast<std::uint16_t>(seed >> 16);
+    }
+
+    auto cheap = [](std::uint8_t v) { return static_cast<std::uint8_t>(v * 7 + 3); };
+    auto costly = [](std::uint16_t v) {
+        std::uint32_t h = v;
+        for(int i = 0; i < 20; ++i) { h = (h ^ (h >> 7)) * 0x9E3779B1u; }
+        return static_cast<std::uint16_t>(h);
+    };
+
+    std::printf("%zu elements:\n", n);
+
+    report("uint8 cheap, iterate: map", best_seconds(5, [&]() {
+        unsigned sum = 0;
+        for(auto v : bytes | map(cheap)) { sum += v; }
+        keep(sum);
+    }), n);
+
+    report("uint8 cheap, iterate: map_lut", best_seconds(5, [&]() {
+        unsigned sum = 0;
+        for(auto v : bytes | map_lut(cheap)) { sum += v; }
+        keep(sum);
+    }), n);
+
+    report("uint8 cheap, collect: map", best_seconds(5, [&]() {
+        auto out = bytes | map(cheap) | collect();
+        keep(out.data());
+    }), n);
+
+    report("uint8 cheap, collect: map_lut", best_seconds(5, [&]() {
+        auto out = bytes | map_lut(cheap) | collect();
+        keep(out.data());
+    }), n);
+
+    report("uint16 costly, iterate: map", best_seconds(3, [&]() {
+        unsigned sum = 0;
+        for(auto v : words | map(costly)) { sum += v; }
+        keep(sum);
+    }), n);
+
+    report("uint16 costly, iterate: map_lut", best_seconds(3, [&]() {
+        unsigned sum = 0;
+        for(auto v : words | map_lut(costly)) { sum += v; }
+        keep(sum);
+    }), n);
+
+    report("uint16 costly, collect: map", best_seconds(3, [&]() {
+        auto out = words | map(costly) | collect();
+        keep(out.data());
+    }), n);
+
+    report("uint16 costly, collect: map_lut", best_seconds(3, [&]() {
+        auto out = words | map_lut(costly) | collect();
+        keep(out.data());
+    }), n);
+}
@@ -0,0 +1,48 @@
+// Three expensive stages (map -> map -> sink), run on one thread and with
+// a pipeline_parallel() boundary after each map, so that each stage has a
+// thread of its own. The overlap needs at least three cores to show.
+
+#include "bench.hpp"
+
+#include "range_map.hpp"
+#include "range_pipeline_parallel.hpp"
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace adaptor;
+
+// About the same amount of work per call for each stage.
+std::uint64_t churn(std::uint64_t v)
+{
+    for(int i = 0; i < 200; ++i) { v = v * 6364136223846793005u + 1442695040888963407u; }
+    return v;
+}
+
+int main()
+{
+    const std::size_t n = 1000000;
+    std::vector<std::uint64_t> x(n);
+    for(std::size_t i = 0; i < n; ++i) { x[i] = i; }
+
+    auto stage1 = [](std::uint64_t v) { return churn(v); };
+    auto stage2 = [](std::uint64_t v) { return churn(v ^ 0x9E3779B97F4A7C15u); };
+
+    std::printf("%zu elements, 3 stages of ~200 multiply-adds each, %u hardware threads:\n",
+                n, std::thread::hardware_concurrency());
+
+    report("sequential", best_seconds(3, [&]() {
+        std::uint64_t sink = 0;
+        for(auto v : x | map(stage1) | map(stage2)) { sink += churn(v); }
+        keep(sink);
+    }), n);
+
+    report("pipeline_parallel per stage", best_seconds(3, [&]() {
+        std::uint64_t sink = 0;
+        for(auto v : x | map(stage1) | pipeline_parallel() | map(stage2) | pipeline_parallel()) {
+            sink += churn(v);
+        }
+        keep(sink);
+    }), n);
+}
@@ -0,0 +1,53 @@
+// Random gathers from a table far larger than the caches, with and
+// without prefetch() ahead of the map doing the gather, at a few
+// distances. The table size in MB can be given as the first argument
+// (default 1024).
+
+#include "bench.hpp"
+
+#include "range_map.hpp"
+#include "range_prefetch.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+using namespace adaptor;
+
+int main(int argc, char** argv)
+{
+    const std::size_t megabytes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1024;
+    const std::size_t size      = megabytes * (1 << 20) / sizeof(std::uint32_t);
+    const std::size_t n         = 20000000;
+
+    std::vector<std::uint32_t> table(size);
+    for(std::size_t i = 0; i < size; ++i) { table[i] = static_cast<std::uint32_t>(i * 2654435761u); }
+
+    std::vector<std::uint32_t> indices(n);
+    std::uint64_t seed = 1;
+    for(auto& i : indices) {
+        seed = seed * 6364136223846793005u + 1442695040888963407u;
+        i = static_cast<std::uint32_t>((seed >> 33) % size);
+    }
+
+    auto gather  = [&table](std::uint32_t i) { return table[i]; };
+    auto address = [&table](std::uint32_t i) { return &table[i]; };
+
+    std::printf("%zu random gathers from a %zu MB table:\n", n, megabytes);
+
+    report("map", best_seconds(3, [&]() {
+        std::uint64_t sum = 0;
+        for(auto v : indices | map(gather)) { sum += v; }
+        keep(sum);
+    }), n);
+
+    for(std::size_t distance : { 8, 32, 64, 128, 256 }) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "prefetch(%zu) | map", distance);
+        report(name, best_seconds(3, [&]() {
+            std::uint64_t sum = 0;
+            for(auto v : indices | prefetch(distance, address) | map(gather)) { sum += v; }
+            keep(sum);
+        }), n);
+    }
+}
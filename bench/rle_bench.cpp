@@ -0,0 +1,87 @@
+// from_rle() against the expanded std::vector: the memory each takes per
+// element, a sequential scan, stride() and random positions, for a column
+// with short runs and one with long runs.
+
+#include "bench.hpp"
+
+#include "range_collect.hpp"
+#include "range_rle.hpp"
+#include "range_stride.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace adaptor;
+
+void run(const char* name, std::size_t mean_run)
+{
+    const std::size_t n = 16 << 20;
+    std::vector<int> x;
+    x.reserve(n);
+    std::uint32_t seed = 1;
+    while(x.size() < n) {
+        seed = seed * 1664525u + 1013904223u;
+        const auto length = std::min<std::size_t>(1 + (seed >> 8) % (2 * mean_run), n - x.size());
+        x.insert(x.end(), length, static_cast<int>(seed >> 24));
+    }
+
+    const auto runs = x | rle() | collect();
+    auto expanded   = from_rle(runs);
+
+    // The runs, plus the end position from_rle() keeps for each.
+    const double bytes = double(runs.size() * (sizeof(runs[0]) + sizeof(std::size_t)));
+    std::printf("\n%s: %zu elements in %zu runs\n", name, n, runs.size());
+    std::printf("%-34s %9.3f bytes/element\n", "vector", double(sizeof(int)));
+    std::printf("%-34s %9.3f bytes/element\n", "from_rle", bytes / double(n));
+
+    report("scan: vector", best_seconds(5, [&]() {
+        long long sum = 0;
+        for(auto v : x) { sum += v; }
+        keep(sum);
+    }), n);
+
+    report("scan: from_rle", best_seconds(5, [&]() {
+        long long sum = 0;
+        for(auto v : expanded) { sum += v; }
+        keep(sum);
+    }), n);
+
+    const std::size_t step = 7;
+    report("stride(7): vector", best_seconds(5, [&]() {
+        long long sum = 0;
+        for(auto v : x | stride(step)) { sum += v; }
+        keep(sum);
+    }), n / step);
+
+    report("stride(7): from_rle", best_seconds(5, [&]() {
+        long long sum = 0;
+        for(auto v : expanded | stride(step)) { sum += v; }
+        keep(sum);
+    }), n / step);
+
+    std::vector<std::size_t> positions(1 << 20);
+    for(auto& p : positions) {
+        seed = seed * 1664525u + 1013904223u;
+        p = (std::size_t(seed) << 8) % n;
+    }
+
+    report("random positions: vector", best_seconds(5, [&]() {
+        long long sum = 0;
+        for(auto p : positions) { sum += x[p]; }
+        keep(sum);
+    }), positions.size());
+
+    report("random positions: from_rle", best_seconds(5, [&]() {
+        long long sum = 0;
+        for(auto p : positions) { sum += expanded[p]; }
+        keep(sum);
+    }), positions.size());
+}
+
+int main()
+{
+    run("runs of about 8", 8);
+    run("runs of about 1000", 1000);
+}
@@ -0,0 +1,102 @@
+// write_to() against fprintf and fwrite: integers and doubles as text,
+// and integers as binary, in the foreground and in the background, to a
+// file in the current directory.
+
+#include "bench.hpp"
+
+#include "range_map.hpp"
+#include "range_write.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using namespace adaptor;
+
+const char* path = "write_bench.out";
+
+template <typename T>
+T same(T v) { return v; }
+
+// Times writing with func, which returns the number of bytes written.
+template <typename Func>
+void run(const char* name, Func&& func)
+{
+    std::size_t bytes = 0;
+    const auto seconds = best_seconds(3, [&]() { bytes = func(); });
+    report_bytes(name, seconds, double(bytes));
+}
+
+int main()
+{
+    const std::size_t n = 4 << 20;
+    std::vector<int>    ints(n);
+    std::vector<double> doubles(n / 4);
+    std::uint32_t seed = 1;
+    for(auto& v : ints) {
+        seed = seed * 1664525u + 1013904223u;
+        v = static_cast<int>(seed) >> (seed & 31);
+    }
+    for(auto& v : doubles) {
+        seed = seed * 1664525u + 1013904223u;
+        v = double(seed) / 1e4 - 2e5;
+    }
+
+    write_options background;
+    background.background = true;
+
+    std::printf("%zu ints, %zu doubles:\n", ints.size(), doubles.size());
+
+    run("int text: fprintf", [&]() {
+        std::FILE* file = std::fopen(path, "wb");
+        for(auto v : ints) { std::fprintf(file, "%d\n", v); }
+        const auto bytes = static_cast<std::size_t>(std::ftell(file));
+        std::fclose(file);
+        return bytes;
+    });
+
+    run("int text: write_to", [&]() {
+        return (ints | write_to<write_format::text>(path)).bytes;
+    });
+
+    run("int text: write_to, background", [&]() {
+        return (ints | write_to<write_format::text>(path, background)).bytes;
+    });
+
+    run("double text: fprintf %.17g", [&]() {
+        std::FILE* file = std::fopen(path, "wb");
+        for(auto v : doubles) { std::fprintf(file, "%.17g\n", v); }
+        const auto bytes = static_cast<std::size_t>(std::ftell(file));
+        std::fclose(file);
+        return bytes;
+    });
+
+    run("double text: write_to", [&]() {
+        return (doubles | write_to<write_format::text>(path)).bytes;
+    });
+
+    run("double text: write_to, background", [&]() {
+        return (doubles | write_to<write_format::text>(path, background)).bytes;
+    });
+
+    run("int binary: fwrite", [&]() {
+        std::FILE* file = std::fopen(path, "wb");
+        const auto bytes = std::fwrite(ints.data(), sizeof(int), ints.size(), file) * sizeof(int);
+        std::fclose(file);
+        return bytes;
+    });
+
+    run("int binary: write_to", [&]() {
+        return (ints | write_to(path)).bytes;
+    });
+
+    run("int binary, via map: write_to", [&]() {
+        return (ints | map(same<int>) | write_to(path)).bytes;
+    });
+
+    run("int binary, via map: background", [&]() {
+        return (ints | map(same<int>) | write_to(path, background)).bytes;
+    });
+
+    std::remove(path);
+}
@@ -0,0 +1,165 @@
+// Building, composing and iterating lazy adaptor pipelines must not
+// allocate: every global allocation is counted, and each pipeline is run
+// between two readings of the count.
+
+#include "check.hpp"
+
+#include "range_cache.hpp"
+#include "range_filter.hpp"
+#include "range_map.hpp"
+#include "range_copy.hpp"
+#include "range_reverse.hpp"
+#include "range_stride.hpp"
+#include "range_unique.hpp"
+
+#include <cstddef>
+#include <cstdlib>
+#include <list>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+namespace
+{
+
+std::size_t allocations = 0;
+
+void* counted_alloc(std::size_t size)
+{
+    ++allocations;
+    if(void* p = std::malloc(size == 0 ? 1 : size)) { return p; }
+    throw std::bad_alloc();
+}
+
+void* counted_aligned_alloc(std::size_t size, std::align_val_t align)
+{
+    ++allocations;
+    const auto a = static_cast<std::size_t>(align);
+    if(void* p = std::aligned_alloc(a, (size + a - 1) / a * a)) { return p; }
+    throw std::bad_alloc();
+}
+
+} // end namespace
+
+void* operator new(std::size_t size) { return counted_alloc(size); }
+void* operator new[](std::size_t size) { return counted_alloc(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return counted_alloc(size); } catch(...) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return counted_alloc(size); } catch(...) { return nullptr; }
+}
+void* operator new(std::size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+void* operator new[](std::size_t size, std::align_val_t align) { return counted_aligned_alloc(size, align); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+
+using namespace adaptor;
+
+// The number of allocations made while running func.
+template <typename Func>
+std::size_t allocations_in(Func&& func)
+{
+    const auto before = allocations;
+    func();
+    return allocations - before;
+}
+
+int main()
+{
+    std::vector<int> x(1000);
+    for(std::size_t i = 0; i < x.size(); ++i) { x[i] = static_cast<int>(i % 37); }
+    std::list<int> l(x.begin(), x.end());
+
+    // Created up front: these own heap memory themselves.
+    auto scale  = std::make_unique<int>(3);
+    auto limit  = std::make_unique<int>(20);
+    auto scale2 = std::make_unique<int>(2);
+    const int offset = 7;
+
+    long sum = 0;
+
+    // The count does see allocations.
+    CHECK(allocations_in([]() { std::vector<int> v(10); }) == 1);
+
+    // Capturing lambdas.
+    CHECK(allocations_in([&]() {
+        for(auto v : x | map([offset](int v) { return v + offset; })
+                       | filter([offset](int v) { return v % offset != 0; })) {
+            sum += v;
+        }
+    }) == 0);
+
+    CHECK(allocations_in([&]() {
+        for(auto v : x | stride(3) | map([&sum](int v) { return v * 2; }) | reverse()) {
+            sum += v;
+        }
+    }) == 0);
+
+    CHECK(allocations_in([&]() {
+        for(auto v : x | slice(10, 900) | unique() | map([offset](int v) { return v - offset; })) {
+            sum += v;
+        }
+    }) == 0);
+
+    CHECK(allocations_in([&]() {
+        for(auto v : l | filter([offset](int v) { return v > offset; }) | reverse() | unique()) {
+            sum += v;
+        }
+    }) == 0);
+
+    // Move-only callables, moved (not copied) into the pipeline.
+    CHECK(allocations_in([&]() {
+        auto pipeline = x | map([p = std::move(scale)](int v) { return v * *p; })
+                          | filter([p = std::move(limit)](int v) { return v < *p; })
+                          | stride(2);
+        for(auto v : pipeline) {
+            sum += v;
+        }
+    }) == 0);
+
+    // Building a pipeline and moving it around.
+    CHECK(allocations_in([&]() {
+        auto p1 = x | reverse() | map([p = std::move(scale2)](int v) { return v + *p; });
+        auto p2 = std::move(p1);
+        sum += *p2.begin();
+    }) == 0);
+
+    // An rvalue container is moved into the pipeline, not copied.
+    std::vector<int> owned(x);
+    CHECK(allocations_in([&]() {
+        auto pipeline = std::move(owned) | map([](int v) { return v + 1; }) | unique();
+        for(auto v : pipeline) {
+            sum += v;
+        }
+    }) == 0);
+
+    // A cache and its copies take memory only from the given resource.
+    {
+        static std::byte buffer[1 << 16];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        CHECK(allocations_in([&]() {
+            auto cached = x | map([](int v) { return v * 3; }) | cache(arena);
+            auto copy = cached;
+            CHECK(copy.resource() == &arena);
+            CHECK(copy.size() == x.size());
+            CHECK(copy[5] == cached[5]);
+            for(auto v : copy | filter([](int v) { return v % 2 == 0; })) {
+                sum += v;
+            }
+        }) == 0);
+    }
+
+    CHECK(sum != 0);
+    return test_result();
+}
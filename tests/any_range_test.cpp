@@ -0,0 +1,97 @@
+#include "check.hpp"
+
+#include "range_any.hpp"
+#include "range_filter.hpp"
+#include "range_map.hpp"
+#include "range_reverse.hpp"
+#include "range_stride.hpp"
+
+#include <array>
+#include <list>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace adaptor;
+
+template <typename T>
+std::vector<T> elements(any_range<T>& r)
+{
+    std::vector<T> out;
+    for(const auto& v : r) {
+        out.push_back(v);
+    }
+    return out;
+}
+
+int main()
+{
+    std::vector<int> x{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
+    std::list<int>   l(x.begin(), x.end());
+
+    // Differently built pipelines behind one type.
+    std::vector<any_range<int>> views;
+    views.emplace_back(x | map([](int v) { return v * v; }));
+    views.emplace_back(l | filter([](int v) { return v % 3 == 0; }));
+    views.emplace_back(x | stride(4) | reverse());
+    views.emplace_back(std::vector<int>{ 42 });
+
+    CHECK(elements(views[0]) == (std::vector<int>{ 1, 4, 9, 16, 25, 36, 49, 64, 81, 100 }));
+    CHECK(elements(views[1]) == (std::vector<int>{ 3, 6, 9 }));
+    CHECK(elements(views[2]) == (std::vector<int>{ 9, 5, 1 }));
+    CHECK(elements(views[3]) == (std::vector<int>{ 42 }));
+
+    // Each begin() starts over.
+    CHECK(elements(views[1]) == (std::vector<int>{ 3, 6, 9 }));
+
+    // More elements than fit in one batch.
+    std::vector<long> big(10000);
+    for(std::size_t i = 0; i < big.size(); ++i) { big[i] = static_cast<long>(i); }
+    any_range<long> all(big | map([](long v) { return v + 1; }));
+    long sum = 0;
+    for(auto v : all) { sum += v; }
+    CHECK(sum == 10000L * 10001L / 2);
+
+    // Elements with non-trivial types.
+    std::vector<std::string> words{ "a", "bb", "ccc" };
+    any_range<std::string> longer(words | map([](const std::string& s) { return s + s; }));
+    CHECK(elements(longer) == (std::vector<std::string>{ "aa", "bbbb", "cccccc" }));
+
+    // A range too big to be stored inline.
+    std::array<int, 1024> local{};
+    local[3] = 7;
+    any_range<int> heap(std::move(local));
+    CHECK(elements(heap).size() == 1024);
+
+    // Moving leaves the source empty, however often it happens.
+    any_range<int> a(x | map([](int v) { return v + 1; }));
+    any_range<int> b(std::move(a));
+    CHECK(elements(a).empty());
+    CHECK(elements(b).size() == x.size());
+
+    any_range<int> c(std::move(a));
+    CHECK(elements(c).empty());
+    CHECK(elements(a).empty());
+
+    any_range<int> d(std::move(heap));
+    any_range<int> e(std::move(heap));
+    CHECK(elements(d).size() == 1024);
+    CHECK(elements(e).empty());
+    CHECK(elements(heap).empty());
+
+    b = std::move(a);
+    CHECK(elements(b).empty());
+    a = std::move(d);
+    CHECK(elements(a).size() == 1024);
+    CHECK(elements(d).empty());
+
+    // Moving away from a range that is being iterated.
+    any_range<int> f(x | map([](int v) { return v; }));
+    auto it = f.begin();
+    CHECK(*it == 1);
+    any_range<int> g(std::move(f));
+    CHECK(f.begin() == f.end());
+    CHECK(elements(g).size() == x.size());
+
+    return test_result();
+}
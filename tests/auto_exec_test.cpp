@@ -0,0 +1,100 @@
+#include "check.hpp"
+
+#include "range_auto_exec.hpp"
+#include "range_filter.hpp"
+#include "range_generator.hpp"
+#include "range_map.hpp"
+#include "range_reverse.hpp"
+#include "range_stride.hpp"
+#include "range_unique.hpp"
+
+#include <atomic>
+#include <list>
+#include <vector>
+
+using namespace adaptor;
+
+generator<int> count_to(int n)
+{
+    for(int i = 1; i <= n; ++i) {
+        co_yield i;
+    }
+}
+
+bool even(int v) { return v % 2 == 0; }
+int  twice(int v) { return v * 2; }
+
+using vector_map    = decltype(std::declval<std::vector<int>&>() | map(twice));
+using list_map      = decltype(std::declval<std::list<int>&>() | map(twice));
+using list_filter   = decltype(std::declval<std::list<int>&>() | filter(even));
+using gen_map       = decltype(std::declval<generator<int>&>() | map(twice));
+using gen_filter    = decltype(std::declval<generator<int>&>() | filter(even));
+using gen_unique    = decltype(std::declval<generator<int>&>() | unique());
+using vector_filter = decltype(std::declval<std::vector<int>&>() | filter(even) | map(twice));
+
+// Only ranges that can really be cut into pieces claim to be splittable.
+static_assert(detail::is_splittable<vector_map>::value, "");
+static_assert(detail::is_splittable<vector_filter>::value, "");
+static_assert(!detail::is_splittable<list_map>::value, "");
+static_assert(!detail::is_splittable<list_filter>::value, "");
+static_assert(!detail::is_splittable<gen_map>::value, "");
+static_assert(!detail::is_splittable<gen_filter>::value, "");
+static_assert(!detail::is_splittable<gen_unique>::value, "");
+
+int main()
+{
+    std::vector<int> x(1000);
+    for(std::size_t i = 0; i < x.size(); ++i) { x[i] = static_cast<int>(i + 1); }
+    std::list<int> l(x.begin(), x.end());
+
+    long sum = 0;
+    auto add = [&sum](int v) { sum += v; };
+
+    // Sources that can't be split run sequentially, through any stage.
+    auto report = l | map(twice) | auto_exec(add);
+    CHECK(report.policy == exec_policy::sequential);
+    CHECK(report.elements == 1000);
+    CHECK(sum == 1001000);
+
+    sum = 0;
+    report = count_to(1000) | map(twice) | auto_exec(add);
+    CHECK(report.policy == exec_policy::sequential);
+    CHECK(sum == 1001000);
+
+    sum = 0;
+    report = count_to(1000) | filter(even) | auto_exec(add);
+    CHECK(report.policy == exec_policy::sequential);
+    CHECK(sum == 250500);
+
+    sum = 0;
+    report = count_to(10) | unique() | auto_exec(add);
+    CHECK(report.policy == exec_policy::sequential);
+    CHECK(sum == 55);
+
+    // Random access pipelines are run as a counted loop, contiguous or not.
+    sum = 0;
+    report = x | auto_exec(add, nullptr, 1);
+    CHECK(report.policy == exec_policy::vectorized);
+    CHECK(sum == 500500);
+
+    sum = 0;
+    report = x | map(twice) | stride(2) | reverse() | auto_exec(add, nullptr, 1);
+    CHECK(report.policy == exec_policy::vectorized);
+    CHECK(report.elements == 500);
+    CHECK(sum == 500000);
+
+    // A filter is split on positions, but run element by element.
+    sum = 0;
+    report = x | filter(even) | auto_exec(add, nullptr, 1);
+    CHECK(report.policy == exec_policy::sequential);
+    CHECK(sum == 250500);
+
+    // Whatever is picked for a large range, every element is seen once.
+    std::vector<int> big(1 << 22, 1);
+    std::atomic<long> total(0);
+    report = big | map(twice) | auto_exec([&total](int v) { total += v; }, nullptr, 4);
+    CHECK(report.policy != exec_policy::sequential);
+    CHECK(total == 2L * (1 << 22));
+
+    return test_result();
+}
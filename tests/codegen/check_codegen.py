@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Checks the machine code of canonical pipelines against hand written loops.
+
+Compiles pipelines.cpp at each optimization level, disassembles it with
+objdump, and for every pair of functions pipeline_X / raw_X checks that:
+
+  - pipeline_X contains no calls (every stage was inlined). Code moved out
+    to pipeline_X.cold (e.g. throwing on a bad argument) isn't part of the
+    loop, and isn't checked;
+  - pipeline_X uses packed vector instructions whenever raw_X does (no
+    stage stopped the loop from being vectorized), unless X is listed in
+    KNOWN_SCALAR.
+
+Exits with 77 (skipped) on targets other than x86-64.
+"""
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+LEVELS = ["-O2", "-O3"]
+
+# Pipelines the compiler isn't expected to vectorize, and why.
+KNOWN_SCALAR = {
+    "filter": "operator++ searches for the next match",
+}
+
+SKIPPED = 77
+
+FUNCTION = re.compile(r"^[0-9a-f]+ <([^>]+)>:$")
+# Packed SIMD: integer ops (p..., vp...) and packed float ops (...ps, ...pd)
+# on vector registers.
+PACKED = re.compile(r"\s(v?p[a-z0-9]+|v?[a-z]+p[sd])\s+.*%[xyz]mm")
+
+
+def disassemble(objdump, obj):
+    out = subprocess.run(
+        [objdump, "-d", "--no-show-raw-insn", obj], check=True, capture_output=True, text=True
+    ).stdout
+    functions = {}
+    current = None
+    for line in out.splitlines():
+        match = FUNCTION.match(line)
+        if match:
+            current = match.group(1)
+            functions[current] = []
+        elif current is not None and line.strip():
+            functions[current].append(line)
+    return functions
+
+
+def calls(body, name):
+    found = []
+    for line in body:
+        match = re.search(r"\scall\S*\s+[0-9a-f]+ <([^>]+)>", line)
+        if match:
+            found.append(match.group(1))
+        # A tail call: a jump out of the function.
+        match = re.search(r"\sjmp\S*\s+[0-9a-f]+ <([^>+]+)>", line)
+        if match and match.group(1) != name and not match.group(1).startswith(name + "."):
+            found.append(match.group(1))
+    return found
+
+
+def vectorized(body):
+    return any(PACKED.search(line) for line in body)
+
+
+def check(functions, level):
+    failures = []
+    for name in sorted(functions):
+        if not name.startswith("pipeline_") or "." in name:
+            continue
+        case = name[len("pipeline_"):]
+        raw = functions.get("raw_" + case)
+        if raw is None:
+            failures.append("{} {}: no raw_{} to compare with".format(level, name, case))
+            continue
+
+        body = functions[name]
+        called = calls(body, name)
+        if called:
+            failures.append("{} {}: calls {}".format(level, name, ", ".join(sorted(set(called)))))
+
+        raw_vec, pipe_vec = vectorized(raw), vectorized(body)
+        status = "vectorized" if pipe_vec else "scalar"
+        if raw_vec and not pipe_vec:
+            if case in KNOWN_SCALAR:
+                status += " (known: {})".format(KNOWN_SCALAR[case])
+            else:
+                failures.append("{} {}: scalar, but raw_{} is vectorized".format(level, name, case))
+        print("{:4} {:<24} {:>4} instructions, raw {:>4}, {}{}".format(
+            level, name, len(body), len(raw), status, ", calls" if called else ""
+        ))
+    return failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--compiler", default=os.environ.get("CXX", "c++"))
+    parser.add_argument("--objdump", default="objdump")
+    parser.add_argument("--include", required=True, help="directory holding the headers")
+    parser.add_argument("--source", default=os.path.join(os.path.dirname(__file__), "pipelines.cpp"))
+    parser.add_argument("--flags", default="-std=c++14 -w")
+    args = parser.parse_args()
+
+    machine = subprocess.run(
+        [args.compiler, "-dumpmachine"], check=True, capture_output=True, text=True
+    ).stdout
+    if not machine.startswith("x86_64"):
+        print("skipped: only x86-64 disassembly is checked (target is {})".format(machine.strip()))
+        return SKIPPED
+
+    failures = []
+    with tempfile.TemporaryDirectory() as workdir:
+        for level in LEVELS:
+            obj = os.path.join(workdir, "pipelines{}.o".format(level))
+            subprocess.run(
+                [args.compiler] + args.flags.split() + [level, "-I", args.include, "-c", args.source, "-o", obj],
+                check=True,
+            )
+            failures += check(disassemble(args.objdump, obj), level)
+
+    for failure in failures:
+        print("FAILED: " + failure)
+    return 1 if failures else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
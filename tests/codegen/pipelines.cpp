@@ -0,0 +1,161 @@
+// Canonical pipelines, each next to the hand written loop it should compile
+// to. check_codegen.py compiles this file and compares every pipeline_X
+// with raw_X: the pipeline must not call anything, and must be vectorized
+// whenever the raw loop is.
+
+#include "range_copy.hpp"
+#include "range_filter.hpp"
+#include "range_map.hpp"
+#include "range_reverse.hpp"
+#include "range_stride.hpp"
+#include "range_take.hpp"
+
+#include <cstddef>
+#include <vector>
+
+using namespace adaptor;
+
+extern "C" {
+
+int raw_map(const std::vector<int>& x)
+{
+    int sum = 0;
+    for(std::size_t i = 0; i < x.size(); ++i) { sum += x[i] * 3; }
+    return sum;
+}
+
+int pipeline_map(std::vector<int>& x)
+{
+    int sum = 0;
+    for(auto v : x | map([](int v) { return v * 3; })) { sum += v; }
+    return sum;
+}
+
+int raw_map_map(const std::vector<int>& x)
+{
+    int sum = 0;
+    for(std::size_t i = 0; i < x.size(); ++i) { sum += x[i] * 3 + 1; }
+    return sum;
+}
+
+int pipeline_map_map(std::vector<int>& x)
+{
+    int sum = 0;
+    for(auto v : x | map([](int v) { return v * 3; }) | map([](int v) { return v + 1; })) { sum += v; }
+    return sum;
+}
+
+int raw_map_slice(const std::vector<int>& x, std::size_t a, std::size_t b)
+{
+    int sum = 0;
+    for(std::size_t i = a; i < b; ++i) { sum += x[i] * 3; }
+    return sum;
+}
+
+int pipeline_map_slice(std::vector<int>& x, std::size_t a, std::size_t b)
+{
+    int sum = 0;
+    for(auto v : x | map([](int v) { return v * 3; }) | slice(a, b)) { sum += v; }
+    return sum;
+}
+
+int raw_reverse_map(const std::vector<int>& x)
+{
+    int sum = 0;
+    for(std::size_t i = x.size(); i-- > 0;) { sum += x[i] * 3; }
+    return sum;
+}
+
+int pipeline_reverse_map(std::vector<int>& x)
+{
+    int sum = 0;
+    for(auto v : x | reverse() | map([](int v) { return v * 3; })) { sum += v; }
+    return sum;
+}
+
+int raw_stride(const std::vector<int>& x, std::size_t k)
+{
+    int sum = 0;
+    for(std::size_t i = 0; i < x.size(); i += k) { sum += x[i]; }
+    return sum;
+}
+
+int pipeline_stride(std::vector<int>& x, std::size_t k)
+{
+    int sum = 0;
+    for(auto v : x | stride(k)) { sum += v; }
+    return sum;
+}
+
+int raw_map_stride(const std::vector<int>& x)
+{
+    int sum = 0;
+    for(std::size_t i = 0; i < x.size(); i += 2) { sum += x[i] * 3; }
+    return sum;
+}
+
+int pipeline_map_stride(std::vector<int>& x)
+{
+    int sum = 0;
+    for(auto v : x | map([](int v) { return v * 3; }) | stride(2)) { sum += v; }
+    return sum;
+}
+
+int raw_take(const std::vector<int>& x, std::size_t n)
+{
+    int sum = 0;
+    const auto last = n < x.size() ? n : x.size();
+    for(std::size_t i = 0; i < last; ++i) { sum += x[i]; }
+    return sum;
+}
+
+int pipeline_take(std::vector<int>& x, std::size_t n)
+{
+    int sum = 0;
+    for(auto v : x | take(n)) { sum += v; }
+    return sum;
+}
+
+int raw_drop_while(const std::vector<int>& x)
+{
+    std::size_t i = 0;
+    while(i < x.size() && x[i] < 100) { ++i; }
+    int sum = 0;
+    for(; i < x.size(); ++i) { sum += x[i]; }
+    return sum;
+}
+
+int pipeline_drop_while(std::vector<int>& x)
+{
+    int sum = 0;
+    for(auto v : x | drop_while([](int v) { return v < 100; })) { sum += v; }
+    return sum;
+}
+
+// Known scalar: a filter's operator++ searches for the next match, which
+// compilers don't vectorize. Only checked for calls.
+int raw_filter(const std::vector<int>& x)
+{
+    int sum = 0;
+    for(std::size_t i = 0; i < x.size(); ++i) { if(x[i] > 0) { sum += x[i]; } }
+    return sum;
+}
+
+int pipeline_filter(std::vector<int>& x)
+{
+    int sum = 0;
+    for(auto v : x | filter([](int v) { return v > 0; })) { sum += v; }
+    return sum;
+}
+
+void raw_map_store(const std::vector<int>& x, int* out)
+{
+    for(std::size_t i = 0; i < x.size(); ++i) { out[i] = x[i] * 3; }
+}
+
+void pipeline_map_store(std::vector<int>& x, int* out)
+{
+    for(auto v : x | map([](int v) { return v * 3; })) { *out++ = v; }
+}
+
+} // extern "C"
@@ -0,0 +1,80 @@
+// compact_into after a filter keeps the same elements, in the same order,
+// as iterating the filter, whichever path it takes. Also built for AVX2
+// and AVX-512 when the machine running the tests has them.
+
+#include "check.hpp"
+
+#include "range_compact.hpp"
+#include "range_filter.hpp"
+
+#include <cstdint>
+#include <list>
+#include <vector>
+
+using namespace adaptor;
+
+template <typename T, typename Source, typename Predicate>
+bool same_as_filter(Source& source, Predicate pred)
+{
+    std::vector<T> want;
+    for(auto v : source | filter(pred)) {
+        want.push_back(v);
+    }
+
+    std::vector<T> got{ T() };
+    const auto n = source | filter(pred) | compact_into(got);
+    got.erase(got.begin());
+    return n == want.size() && got == want;
+}
+
+struct pair
+{
+    int a;
+    int b;
+
+    bool operator==(const pair& other) const { return a == other.a && b == other.b; }
+};
+
+int main()
+{
+    std::uint32_t seed = 1;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+
+    // Sizes around the vector width and the buffer size.
+    for(std::size_t size : { 0, 1, 7, 8, 9, 15, 16, 17, 100, 1023, 1024, 1025, 5000, 100000 }) {
+        std::vector<int> ints(size);
+        std::vector<float> floats(size);
+        std::vector<std::uint32_t> words(size);
+        std::vector<short> shorts(size);
+        std::vector<pair> pairs(size);
+        for(std::size_t i = 0; i < size; ++i) {
+            ints[i]   = static_cast<int>(next() % 1000) - 500;
+            floats[i] = static_cast<float>(ints[i]) / 7;
+            words[i]  = next();
+            shorts[i] = static_cast<short>(ints[i]);
+            pairs[i]  = pair{ ints[i], static_cast<int>(i) };
+        }
+        std::list<int> list(ints.begin(), ints.end());
+
+        CHECK(same_as_filter<int>(ints, [](int v) { return v % 2 == 0; }));
+        CHECK(same_as_filter<int>(ints, [](int v) { return v > 400; }));
+        CHECK(same_as_filter<int>(ints, [](int) { return true; }));
+        CHECK(same_as_filter<int>(ints, [](int) { return false; }));
+        CHECK(same_as_filter<float>(floats, [](float v) { return v < 0; }));
+        CHECK(same_as_filter<std::uint32_t>(words, [](std::uint32_t v) { return (v & 3) == 1; }));
+        CHECK(same_as_filter<short>(shorts, [](short v) { return v % 3 == 0; }));
+        CHECK(same_as_filter<pair>(pairs, [](const pair& p) { return p.a > p.b % 100; }));
+        CHECK(same_as_filter<int>(list, [](int v) { return v % 2 == 0; }));
+
+        // The predicate sees every element once, in order.
+        std::vector<int> seen;
+        std::vector<int> out;
+        ints | filter([&seen](int v) { seen.push_back(v); return v > 0; }) | compact_into(out);
+        CHECK(seen == ints);
+    }
+
+    return test_result();
+}
@@ -0,0 +1,140 @@
+// take_while, drop_while and the searching terminals: empty ranges,
+// predicates that never match, and where the first match is.
+
+#include "check.hpp"
+
+#include "range_find.hpp"
+#include "range_map.hpp"
+#include "range_take.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <list>
+#include <vector>
+
+using namespace adaptor;
+
+int same(int v) { return v; }
+bool never(int) { return false; }
+bool always(int) { return true; }
+
+template <typename Range>
+std::vector<int> values(Range&& r)
+{
+    std::vector<int> out;
+    for(auto v : r) { out.push_back(v); }
+    return out;
+}
+
+void take_while_test()
+{
+    std::vector<int> empty;
+    CHECK(values(empty | take_while(always)).empty());
+
+    std::list<int> x{ 1, 2, 3, 10, 4 };
+    int calls = 0;
+    auto small = [&calls](int v) { ++calls; return v < 5; };
+    CHECK(values(x | take_while(small)) == std::vector<int>({ 1, 2, 3 }));
+    CHECK(calls == 4);
+
+    CHECK(values(x | take_while(never)).empty());
+    CHECK(values(x | take_while(always)) == std::vector<int>({ 1, 2, 3, 10, 4 }));
+}
+
+void drop_while_test()
+{
+    std::vector<int> empty;
+    CHECK(values(empty | drop_while(always)).empty());
+
+    std::vector<int> x{ 1, 2, 3, 10, 4 };
+    CHECK(values(x | drop_while([](int v) { return v < 5; })) == std::vector<int>({ 10, 4 }));
+    CHECK(values(x | drop_while(never)) == x);
+    CHECK(values(x | drop_while(always)).empty());
+}
+
+void find_first_test()
+{
+    std::vector<int> empty;
+    CHECK(!(empty | find_first(always)));
+    CHECK(!(empty | any_of(always)));
+    CHECK(empty | all_of(never));
+
+    std::list<int> x{ 1, 2, 3, 4, 5 };
+    auto found = x | find_first([](int v) { return v % 2 == 0; });
+    CHECK(found && found.value == 2);
+
+    auto missing = x | find_first(never);
+    CHECK(!missing && missing.value == 0);
+
+    auto last = x | find_first([](int v) { return v == 5; });
+    CHECK(last && last.value == 5);
+
+    CHECK(x | any_of([](int v) { return v == 5; }));
+    CHECK(!(x | any_of(never)));
+    CHECK(x | all_of([](int v) { return v > 0; }));
+    CHECK(!(x | all_of([](int v) { return v < 5; })));
+
+    // Stops at the first match.
+    int calls = 0;
+    CHECK(x | any_of([&calls](int v) { ++calls; return v == 2; }));
+    CHECK(calls == 2);
+}
+
+void find_first_parallel_test()
+{
+    std::vector<int> empty;
+    CHECK(!(empty | find_first_parallel(always, 4)));
+    CHECK(!(empty | map(same) | find_first_parallel(always, 4)));
+
+    std::vector<int> x(10000);
+    for(std::size_t i = 0; i < x.size(); ++i) { x[i] = static_cast<int>(i); }
+
+    for(std::size_t threads : { 1, 2, 4, 7 }) {
+        CHECK(!(x | find_first_parallel(never, threads)));
+        CHECK(!(x | map(same) | find_first_parallel(never, threads)));
+
+        // Only the last element, in the last piece.
+        auto last = x | map(same) | find_first_parallel([](int v) { return v == 9999; }, threads);
+        CHECK(last && last.value == 9999);
+
+        // Matches in every piece: the earliest has to win.
+        for(int round = 0; round < 20; ++round) {
+            auto found = x | find_first_parallel([](int v) { return v % 97 == 96; }, threads);
+            CHECK(found && found.value == 96);
+
+            auto mapped = x | map(same) | find_first_parallel([](int v) { return v >= 5000; }, threads);
+            CHECK(mapped && mapped.value == 5000);
+        }
+    }
+
+    // Fewer elements than pieces.
+    std::vector<int> few{ 1, 2, 3 };
+    auto small = few | find_first_parallel([](int v) { return v > 1; }, 8);
+    CHECK(small && small.value == 2);
+}
+
+// drop_while's begin() scans the prefix it drops; it must be scanned once,
+// not once for every piece.
+void find_first_parallel_drop_while_test()
+{
+    std::vector<int> x(1000);
+    for(std::size_t i = 0; i < x.size(); ++i) { x[i] = static_cast<int>(i); }
+
+    std::atomic<int> calls(0);
+    auto prefix = [&calls](int v) { ++calls; return v < 100; };
+
+    auto found = x | drop_while(prefix) | find_first_parallel([](int v) { return v % 50 == 0; }, 4);
+    CHECK(found && found.value == 100);
+    CHECK(calls.load() == 101);
+}
+
+int main()
+{
+    take_while_test();
+    drop_while_test();
+    find_first_test();
+    find_first_parallel_test();
+    find_first_parallel_drop_while_test();
+
+    return test_result();
+}
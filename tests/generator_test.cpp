@@ -0,0 +1,92 @@
+// generator sources, on the consumer's thread and (through
+// pipeline_parallel) on a thread of their own.
+
+#include "check.hpp"
+
+#include "range_filter.hpp"
+#include "range_generator.hpp"
+#include "range_map.hpp"
+#include "range_pipeline_parallel.hpp"
+#include "range_stride.hpp"
+#include "range_unique.hpp"
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace adaptor;
+
+generator<int> count_to(int n)
+{
+    for(int i = 1; i <= n; ++i) {
+        co_yield i;
+    }
+}
+
+generator<int> repeats(int n)
+{
+    for(int i = 0; i < n; ++i) {
+        co_yield i / 3;
+    }
+}
+
+generator<int> throws_after(int n)
+{
+    for(int i = 0; i < n; ++i) {
+        co_yield i;
+    }
+    throw std::runtime_error("producer failed");
+}
+
+generator<int> record_thread(std::thread::id& id)
+{
+    id = std::this_thread::get_id();
+    co_yield 1;
+}
+
+template <typename Range>
+std::vector<int> elements(Range&& r)
+{
+    std::vector<int> out;
+    for(auto v : r) {
+        out.push_back(v);
+    }
+    return out;
+}
+
+bool odd(int v) { return v % 2 != 0; }
+int  twice(int v) { return v * 2; }
+
+int main()
+{
+    // On the consumer's thread.
+    CHECK(elements(count_to(5)) == (std::vector<int>{ 1, 2, 3, 4, 5 }));
+    CHECK(elements(count_to(0)).empty());
+    CHECK(elements(count_to(9) | filter(odd) | map(twice)) == (std::vector<int>{ 2, 6, 10, 14, 18 }));
+    CHECK(elements(count_to(10) | stride(4)) == (std::vector<int>{ 1, 5, 9 }));
+    CHECK(elements(repeats(9) | unique()) == (std::vector<int>{ 0, 1, 2 }));
+
+    // On a producer thread, with more elements than fit in the queue.
+    const auto all = elements(count_to(100000));
+    CHECK(elements(count_to(100000) | pipeline_parallel(64, 2)) == all);
+    CHECK(elements(count_to(100000) | pipeline_parallel() | map(twice) | pipeline_parallel()).size() == all.size());
+    CHECK(elements(repeats(3000) | pipeline_parallel(7, 3) | unique()).size() == 1000);
+
+    std::thread::id producer;
+    CHECK(elements(record_thread(producer) | pipeline_parallel()).size() == 1);
+    CHECK(producer != std::thread::id());
+    CHECK(producer != std::this_thread::get_id());
+
+    // Exceptions reach the consumer either way.
+    bool thrown = false;
+    try { elements(throws_after(10)); }
+    catch(const std::runtime_error&) { thrown = true; }
+    CHECK(thrown);
+
+    thrown = false;
+    try { elements(throws_after(5000) | pipeline_parallel(16, 2)); }
+    catch(const std::runtime_error&) { thrown = true; }
+    CHECK(thrown);
+
+    return test_result();
+}
@@ -0,0 +1,107 @@
+// group_by and aggregate_by: runs of equal keys, and what is folded over
+// each run.
+
+#include "check.hpp"
+
+#include "range_group_by.hpp"
+
+#include <list>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace adaptor;
+
+int tens(int v) { return v / 10; }
+int identity(int v) { return v; }
+
+// (key, size) for each group.
+template <typename Range>
+std::vector<std::pair<int, int>> group_sizes(Range&& r)
+{
+    std::vector<std::pair<int, int>> out;
+    for(auto group : r) {
+        int n = 0;
+        for(auto it = group.second.begin(); it != group.second.end(); ++it) { ++n; }
+        out.emplace_back(group.first, n);
+    }
+    return out;
+}
+
+template <typename Range>
+std::vector<std::pair<int, int>> aggregates(Range&& r)
+{
+    std::vector<std::pair<int, int>> out;
+    for(const auto& group : r) {
+        out.emplace_back(group.first, group.second);
+    }
+    return out;
+}
+
+using groups = std::vector<std::pair<int, int>>;
+
+int main()
+{
+    auto sum = [](int acc, int v) { return acc + v; };
+
+    // Empty.
+    std::vector<int> none;
+    CHECK(group_sizes(none | group_by(tens)).empty());
+    CHECK(aggregates(none | aggregate_by(tens, sum, 0)).empty());
+
+    // A single group, of one element and of many.
+    std::vector<int> one{ 4 };
+    CHECK(group_sizes(one | group_by(tens)) == (groups{ { 0, 1 } }));
+    CHECK(aggregates(one | aggregate_by(tens, sum, 100)) == (groups{ { 0, 104 } }));
+
+    std::vector<int> single{ 11, 12, 13, 19 };
+    CHECK(group_sizes(single | group_by(tens)) == (groups{ { 1, 4 } }));
+    CHECK(aggregates(single | aggregate_by(tens, sum, 0)) == (groups{ { 1, 55 } }));
+
+    // All distinct keys: a group per element.
+    std::vector<int> distinct{ 5, 3, 8, 1, 9 };
+    CHECK(group_sizes(distinct | group_by(identity))
+          == (groups{ { 5, 1 }, { 3, 1 }, { 8, 1 }, { 1, 1 }, { 9, 1 } }));
+    CHECK(aggregates(distinct | aggregate_by(identity, sum, 1))
+          == (groups{ { 5, 6 }, { 3, 4 }, { 8, 9 }, { 1, 2 }, { 9, 10 } }));
+
+    // Only consecutive equal keys group; a key can come back later.
+    std::list<int> runs{ 1, 2, 15, 11, 3, 30, 31, 32, 7 };
+    CHECK(group_sizes(runs | group_by(tens))
+          == (groups{ { 0, 2 }, { 1, 2 }, { 0, 1 }, { 3, 3 }, { 0, 1 } }));
+    CHECK(aggregates(runs | aggregate_by(tens, sum, 0))
+          == (groups{ { 0, 3 }, { 1, 26 }, { 0, 3 }, { 3, 93 }, { 0, 7 } }));
+
+    // The groups are views of the underlying elements.
+    std::vector<int> x{ 20, 21, 40 };
+    auto first = *(x | group_by(tens)).begin();
+    CHECK(&*first.second.begin() == &x[0]);
+
+    // Each group starts from its own copy of init.
+    auto append = [](std::string acc, int v) { return acc + std::to_string(v); };
+    std::vector<std::pair<int, std::string>> strings;
+    for(const auto& group : runs | aggregate_by(tens, append, std::string(">"))) {
+        strings.push_back(group);
+    }
+    CHECK(strings.size() == 5);
+    CHECK(strings[0].second == ">12");
+    CHECK(strings[3].second == ">303132");
+
+    // Move-only key and aggregate functions are moved into the pipeline.
+    auto divisor = std::make_unique<int>(10);
+    auto weight  = std::make_unique<int>(2);
+    auto key     = [d = std::move(divisor)](int v) { return v / *d; };
+    auto agg     = [w = std::move(weight)](int acc, int v) { return acc + v * *w; };
+    CHECK(aggregates(runs | aggregate_by(std::move(key), std::move(agg), 0))
+          == (groups{ { 0, 6 }, { 1, 52 }, { 0, 6 }, { 3, 186 }, { 0, 14 } }));
+
+    auto owned_key = [d = std::make_unique<int>(10)](int v) { return v / *d; };
+    CHECK(group_sizes(runs | group_by(std::move(owned_key))).size() == 5);
+
+    // Iterating twice gives the same groups.
+    auto grouped = runs | aggregate_by(tens, sum, 0);
+    CHECK(aggregates(grouped) == aggregates(grouped));
+
+    return test_result();
+}
@@ -0,0 +1,149 @@
+// hash_into() and crc32c(): digests against those of the reference
+// implementations, and the same digest whether a range is hashed in place
+// or gathered into the buffer first. Also built with -msse4.2, where
+// CRC-32C uses the crc32 instruction instead of the tables.
+
+#include "check.hpp"
+
+#include "range_hash.hpp"
+#include "range_map.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <vector>
+
+using namespace adaptor;
+
+template <typename T>
+T same(T v) { return v; }
+
+// Byte i is i * 7 + 1.
+std::vector<unsigned char> pattern(std::size_t n)
+{
+    std::vector<unsigned char> out(n);
+    for(std::size_t i = 0; i < n; ++i) { out[i] = static_cast<unsigned char>(i * 7 + 1); }
+    return out;
+}
+
+std::vector<unsigned char> text(const char* s)
+{
+    std::vector<unsigned char> out;
+    for(; *s != '\0'; ++s) { out.push_back(static_cast<unsigned char>(*s)); }
+    return out;
+}
+
+// From the reference XXH64 with seed 0: the empty input, the tail loops
+// (1 to 3, 4 and 8 bytes), one byte either side of a 32 byte stripe, and
+// inputs of several stripes.
+struct known_digest
+{
+    std::size_t   size;
+    std::uint64_t digest;
+};
+
+const known_digest xxh64_digests[] = {
+    { 0, 0xEF46DB3751D8E999ULL },
+    { 1, 0x8A4127811B21E730ULL },
+    { 2, 0x2B319EC16221CA2BULL },
+    { 3, 0xB6E6C910C2FD373AULL },
+    { 4, 0x22EDA2CF6AF4C124ULL },
+    { 7, 0x34084D91A233A751ULL },
+    { 8, 0xC6F1803A5E0B3222ULL },
+    { 31, 0x6AB1C40E29F50073ULL },
+    { 32, 0x5A0756FBE9ECD3D1ULL },
+    { 33, 0xDC50CDC37BB9C183ULL },
+    { 64, 0x90083DA9CDB9D795ULL },
+    { 100, 0xD248BFC5208B0B16ULL },
+    { 1000, 0x6BE03ACBF959C413ULL },
+};
+
+void xxhash64_test()
+{
+    for(const auto& known : xxh64_digests) {
+        auto x = pattern(known.size);
+        CHECK((x | hash_into()) == known.digest);
+
+        std::list<unsigned char> l(x.begin(), x.end());
+        CHECK((l | hash_into()) == known.digest);
+    }
+
+    auto abc = text("abc");
+    CHECK((abc | hash_into()) == 0x44BC2CF5AD770999ULL);
+    auto digits = text("123456789");
+    CHECK((digits | hash_into()) == 0x8CB841DB40E6AE83ULL);
+
+    // Batch sizes don't change the digest.
+    auto x = pattern(1000);
+    for(std::size_t batch : { 1, 3, 31, 32, 33, 999 }) {
+        xxhash64 hasher;
+        for(std::size_t i = 0; i < x.size(); i += batch) {
+            hasher.update(x.data() + i, std::min(batch, x.size() - i));
+        }
+        CHECK(hasher.digest() == 0x6BE03ACBF959C413ULL);
+    }
+}
+
+void crc32c_test()
+{
+    auto digits = text("123456789");
+    CHECK((digits | crc32c()) == 0xE3069283u);
+
+    std::list<unsigned char> l(digits.begin(), digits.end());
+    CHECK((l | crc32c()) == 0xE3069283u);
+
+    std::vector<unsigned char> empty;
+    CHECK((empty | crc32c()) == 0u);
+
+    // 32 zero bytes and 32 bytes of 0xFF, from RFC 3720 (iSCSI).
+    std::vector<unsigned char> zeros(32, 0);
+    CHECK((zeros | crc32c()) == 0x8A9136AAu);
+    std::vector<unsigned char> ones(32, 0xFF);
+    CHECK((ones | crc32c()) == 0x62A8AB43u);
+
+    // Bytes left over after the 8 byte steps, at each offset.
+    auto x = pattern(1000);
+    for(std::size_t batch : { 1, 3, 7, 8, 9, 999 }) {
+        crc32c_hasher hasher;
+        for(std::size_t i = 0; i < x.size(); i += batch) {
+            hasher.update(x.data() + i, std::min(batch, x.size() - i));
+        }
+        CHECK(hasher.digest() == (x | crc32c()));
+    }
+}
+
+// Contiguous ranges are hashed in place, anything else is gathered into a
+// 4KB buffer: the digests must be the same, including across buffer
+// boundaries and for elements wider than a byte.
+void buffered_test()
+{
+    for(std::size_t n : { 0, 1, 31, 33, 4095, 4096, 4097, 10000 }) {
+        auto x = pattern(n);
+        CHECK((x | map(same<unsigned char>) | hash_into()) == (x | hash_into()));
+        CHECK((x | map(same<unsigned char>) | crc32c()) == (x | crc32c()));
+    }
+
+    std::vector<std::uint32_t> words(5000);
+    for(std::size_t i = 0; i < words.size(); ++i) {
+        words[i] = static_cast<std::uint32_t>(i * 2654435761u);
+    }
+    CHECK((words | map(same<std::uint32_t>) | hash_into()) == (words | hash_into()));
+    CHECK((words | map(same<std::uint32_t>) | crc32c()) == (words | crc32c()));
+
+    // The same bytes, laid out as words.
+    std::vector<unsigned char> bytes(words.size() * sizeof(std::uint32_t));
+    std::memcpy(bytes.data(), words.data(), bytes.size());
+    CHECK((words | hash_into()) == (bytes | hash_into()));
+    CHECK((words | crc32c()) == (bytes | crc32c()));
+}
+
+int main()
+{
+    xxhash64_test();
+    crc32c_test();
+    buffered_test();
+
+    return test_result();
+}
@@ -0,0 +1,118 @@
+// Random access members of the adaptors' iterators only exist when the
+// underlying iterators are random access, so traits and SFINAE see them
+// exactly when they work.
+
+#include "check.hpp"
+
+#include "iterator_helpers.hpp"
+#include "range_filter.hpp"
+#include "range_map.hpp"
+#include "range_prefetch.hpp"
+#include "range_reverse.hpp"
+#include "range_stride.hpp"
+
+#include <list>
+#include <utility>
+#include <vector>
+
+using namespace adaptor;
+
+template <typename It, typename = void>
+struct has_plus : std::false_type { };
+template <typename It>
+struct has_plus<It, detail::void_t<decltype(std::declval<It&>() + 1)>> : std::true_type { };
+
+template <typename It, typename = void>
+struct has_plus_assign : std::false_type { };
+template <typename It>
+struct has_plus_assign<It, detail::void_t<decltype(std::declval<It&>() += 1)>> : std::true_type { };
+
+template <typename It, typename = void>
+struct has_difference : std::false_type { };
+template <typename It>
+struct has_difference<It, detail::void_t<decltype(std::declval<It&>() - std::declval<It&>())>> : std::true_type { };
+
+template <typename It, typename = void>
+struct has_less : std::false_type { };
+template <typename It>
+struct has_less<It, detail::void_t<decltype(std::declval<It&>() < std::declval<It&>())>> : std::true_type { };
+
+template <typename It, typename = void>
+struct has_index : std::false_type { };
+template <typename It>
+struct has_index<It, detail::void_t<decltype(std::declval<It&>()[0])>> : std::true_type { };
+
+template <typename It>
+constexpr bool has_random_access_members()
+{
+    return has_plus<It>::value && has_plus_assign<It>::value && has_difference<It>::value
+        && has_less<It>::value;
+}
+
+template <typename It>
+constexpr bool has_no_random_access_members()
+{
+    return !has_plus<It>::value && !has_plus_assign<It>::value && !has_difference<It>::value
+        && !has_less<It>::value && !has_index<It>::value;
+}
+
+int twice(int v) { return v * 2; }
+bool even(int v) { return v % 2 == 0; }
+const int* address(const int& v) { return &v; }
+
+template <typename Range>
+using iterator_of = typename std::remove_reference_t<Range>::iterator;
+
+using vector_map     = iterator_of<decltype(std::declval<std::vector<int>&>() | map(twice))>;
+using list_map       = iterator_of<decltype(std::declval<std::list<int>&>() | map(twice))>;
+using vector_reverse = iterator_of<decltype(std::declval<std::vector<int>&>() | reverse())>;
+using list_reverse   = iterator_of<decltype(std::declval<std::list<int>&>() | reverse())>;
+using vector_stride  = iterator_of<decltype(std::declval<std::vector<int>&>() | stride(2))>;
+using list_stride    = iterator_of<decltype(std::declval<std::list<int>&>() | stride(2))>;
+using filter_map     = iterator_of<decltype(std::declval<std::vector<int>&>() | filter(even) | map(twice))>;
+
+static_assert(has_random_access_members<vector_map>(), "");
+static_assert(has_random_access_members<vector_reverse>(), "");
+static_assert(has_index<vector_reverse>::value, "");
+static_assert(has_random_access_members<vector_stride>(), "");
+static_assert(has_index<vector_stride>::value, "");
+
+static_assert(has_no_random_access_members<list_map>(), "");
+static_assert(has_no_random_access_members<list_reverse>(), "");
+static_assert(has_no_random_access_members<list_stride>(), "");
+static_assert(has_no_random_access_members<filter_map>(), "");
+
+// Forward iterators are default constructible.
+using vector_prefetch = iterator_of<decltype(std::declval<std::vector<int>&>() | prefetch(4, address))>;
+
+static_assert(
+    std::is_base_of<std::forward_iterator_tag, vector_prefetch::iterator_category>::value, ""
+);
+static_assert(std::is_default_constructible<vector_prefetch>::value, "");
+
+int main()
+{
+    std::vector<int> x{ 1, 2, 3, 4, 5, 6 };
+
+    auto m = x | map(twice);
+    CHECK(m.end() - m.begin() == 6);
+    CHECK(*(m.begin() + 2) == 6);
+    CHECK(m.begin() < m.end());
+
+    auto r = x | reverse();
+    CHECK(r.begin()[1] == 5);
+    CHECK(*(2 + r.begin()) == 4);
+
+    auto s = x | stride(4);
+    CHECK(s.end() - s.begin() == 2);
+    CHECK(s.begin()[1] == 5);
+
+    auto p = x | prefetch(2, address);
+    vector_prefetch first;
+    CHECK(first == vector_prefetch());
+    first = p.begin();
+    CHECK(*first == 1);
+    CHECK(first != p.end());
+
+    return test_result();
+}
@@ -0,0 +1,119 @@
+// pipeline_parallel(): order is kept across the thread boundary, the
+// producer stops when the range is destroyed early, and exceptions thrown
+// upstream reach the consumer.
+
+#include "check.hpp"
+
+#include "range_filter.hpp"
+#include "range_map.hpp"
+#include "range_pipeline_parallel.hpp"
+#include "range_unique.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace adaptor;
+
+template <typename Range>
+std::vector<int> elements(Range&& r)
+{
+    std::vector<int> out;
+    for(auto v : r) {
+        out.push_back(v);
+    }
+    return out;
+}
+
+int twice(int v) { return v * 2; }
+bool odd(int v) { return v % 2 != 0; }
+
+int main()
+{
+    const int n = 100000;
+    std::vector<int> x(n);
+    for(int i = 0; i < n; ++i) { x[i] = i; }
+
+    // Order, for batch sizes and queue lengths from one up, with partial
+    // last batches.
+    std::vector<int> doubled;
+    for(auto v : x) { doubled.push_back(v * 2); }
+    for(std::size_t batch_size : { 1, 3, 64, 1024, 200000 }) {
+        for(std::size_t batches : { 1, 2, 8 }) {
+            CHECK(elements(x | map(twice) | pipeline_parallel(batch_size, batches)) == doubled);
+        }
+    }
+
+    // Several boundaries, and order dependent stages after them.
+    std::vector<int> want;
+    for(auto v : x) { if(v % 2 != 0) { want.push_back(v / 10 * 2); } }
+    auto tenth = [](int v) { return v / 10; };
+    want.erase(std::unique(want.begin(), want.end()), want.end());
+    CHECK(elements(x | filter(odd) | pipeline_parallel(100, 4) | map(tenth)
+                     | pipeline_parallel(7, 2) | map(twice) | unique()) == want);
+
+    std::vector<int> empty;
+    CHECK(elements(empty | map(twice) | pipeline_parallel()).empty());
+
+    // Destroying the range stops the producer at its next batch, however
+    // much room is left in the queue.
+    {
+        const int total = 1000000;
+        std::vector<int> big(total);
+        std::atomic<int>  produced(0);
+        std::atomic<bool> leaving(false);
+        auto count = [&produced, &leaving](int v) {
+            // Holds the producer back until the consumer is on its way out.
+            if(produced.fetch_add(1) == 100) {
+                while(!leaving.load()) { std::this_thread::yield(); }
+            }
+            return v;
+        };
+        {
+            auto r = big | map(count) | pipeline_parallel(16, total / 16);
+            auto it = r.begin();
+            CHECK(*it == 0);
+            leaving.store(true);
+        }
+        CHECK(produced.load() < total / 2);
+    }
+
+    // A range that is never iterated never starts a thread.
+    {
+        std::atomic<int> calls(0);
+        auto count = [&calls](int v) { ++calls; return v; };
+        {
+            auto r = x | map(count) | pipeline_parallel();
+        }
+        CHECK(calls.load() == 0);
+    }
+
+    // Exceptions thrown upstream are rethrown downstream, after the
+    // elements produced before them.
+    for(std::size_t batch_size : { 1, 16, 1000 }) {
+        auto fail_at = [](int v) {
+            if(v == 5000) { throw std::runtime_error("upstream failed"); }
+            return v;
+        };
+        std::vector<int> seen;
+        bool thrown = false;
+        try {
+            for(auto v : x | map(fail_at) | pipeline_parallel(batch_size, 4)) {
+                seen.push_back(v);
+            }
+        }
+        catch(const std::runtime_error&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+        CHECK(seen.size() <= 5000);
+        CHECK(seen.size() >= 5000 - batch_size);
+        bool ordered = true;
+        for(std::size_t i = 0; i < seen.size(); ++i) { ordered = ordered && seen[i] == static_cast<int>(i); }
+        CHECK(ordered);
+    }
+
+    return test_result();
+}
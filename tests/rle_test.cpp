@@ -0,0 +1,175 @@
+// rle() and from_rle(): runs round trip to the original elements, whether
+// walked one at a time or reached by jumps (which find their run with
+// run_near() when short and run_of() when long), including over runs of
+// length zero.
+
+#include "check.hpp"
+
+#include "range_collect.hpp"
+#include "range_copy.hpp"
+#include "range_rle.hpp"
+#include "range_stride.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+using namespace adaptor;
+
+using runs_type = std::vector<std::pair<int, std::size_t>>;
+
+// Runs of 1 to 20 equal values, with some runs of 1 next to each other.
+std::vector<int> column(std::size_t runs)
+{
+    std::vector<int> out;
+    std::uint32_t seed = 7;
+    for(std::size_t i = 0; i < runs; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const auto length = (seed >> 28) < 4 ? 1 : 1 + (seed >> 16) % 20;
+        out.insert(out.end(), length, static_cast<int>(i % 5));
+    }
+    return out;
+}
+
+template <typename Range>
+std::vector<int> values(Range&& r)
+{
+    std::vector<int> out;
+    for(auto v : r) { out.push_back(v); }
+    return out;
+}
+
+template <typename Range>
+void check_same(Range&& r, const std::vector<int>& x)
+{
+    CHECK(static_cast<std::size_t>(r.end() - r.begin()) == x.size());
+    CHECK(values(r) == x);
+
+    // Backwards, so that every -- at the start of a run steps into the
+    // run before it.
+    std::vector<int> backwards;
+    for(auto it = r.end(); it != r.begin(); ) {
+        --it;
+        backwards.push_back(*it);
+    }
+    CHECK(std::vector<int>(backwards.rbegin(), backwards.rend()) == x);
+}
+
+// From every position, every jump of up to 8 either way that stays in the
+// range, with += and -=.
+template <typename Range>
+void check_short_jumps(Range&& r, const std::vector<int>& x)
+{
+    const auto n = static_cast<std::ptrdiff_t>(x.size());
+    for(std::ptrdiff_t i = 0; i < n; ++i) {
+        for(std::ptrdiff_t d = -8; d <= 8; ++d) {
+            if(i + d < 0 || i + d >= n) { continue; }
+
+            auto forward = r.begin() + i;
+            forward += d;
+            CHECK(*forward == x[static_cast<std::size_t>(i + d)]);
+
+            auto backward = r.begin() + i;
+            backward -= -d;
+            CHECK(*backward == x[static_cast<std::size_t>(i + d)]);
+            CHECK(forward == backward);
+        }
+    }
+}
+
+void round_trip_test()
+{
+    auto x = column(500);
+    const auto runs = x | rle() | collect();
+    CHECK(runs.size() < x.size());
+
+    auto expanded = from_rle(runs);
+    CHECK(expanded.size() == x.size());
+    check_same(expanded, x);
+
+    for(std::size_t i = 0; i < x.size(); ++i) {
+        CHECK(expanded[i] == x[i]);
+    }
+
+    check_short_jumps(expanded, x);
+
+    // Long jumps, to random positions.
+    auto it = expanded.begin();
+    std::ptrdiff_t position = 0;
+    std::uint32_t seed = 11;
+    for(int i = 0; i < 10000; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const auto target = static_cast<std::ptrdiff_t>((seed >> 8) % x.size());
+        it += target - position;
+        position = target;
+        CHECK(*it == x[static_cast<std::size_t>(position)]);
+        CHECK(it - expanded.begin() == position);
+        CHECK(expanded.begin()[position] == x[static_cast<std::size_t>(position)]);
+    }
+}
+
+void zero_length_runs_test()
+{
+    const runs_type runs{ { 9, 0 }, { 1, 2 }, { 2, 0 }, { 3, 1 }, { 4, 0 }, { 4, 0 }, { 5, 3 }, { 6, 0 } };
+    const std::vector<int> x{ 1, 1, 3, 5, 5, 5 };
+
+    auto expanded = from_rle(runs);
+    CHECK(expanded.size() == x.size());
+    check_same(expanded, x);
+    check_short_jumps(expanded, x);
+
+    for(std::size_t i = 0; i < x.size(); ++i) {
+        CHECK(expanded[i] == x[i]);
+    }
+
+    const runs_type only_empty{ { 1, 0 }, { 2, 0 } };
+    auto none = from_rle(only_empty);
+    CHECK(none.size() == 0);
+    CHECK(none.begin() == none.end());
+}
+
+void empty_test()
+{
+    const runs_type runs;
+    auto expanded = from_rle(runs);
+    CHECK(expanded.size() == 0);
+    CHECK(expanded.begin() == expanded.end());
+    CHECK(values(expanded).empty());
+
+    std::vector<int> x;
+    CHECK((x | rle() | collect()).empty());
+}
+
+void stride_slice_test()
+{
+    auto x = column(200);
+    const auto runs = x | rle() | collect();
+    auto expanded = from_rle(runs);
+
+    for(std::size_t step : { 1, 2, 3, 7, 50 }) {
+        std::vector<int> expected;
+        for(std::size_t i = 0; i < x.size(); i += step) { expected.push_back(x[i]); }
+        CHECK(values(expanded | stride(step)) == expected);
+    }
+
+    const std::size_t from = 37;
+    const std::size_t to   = x.size() - 41;
+    const std::vector<int> middle(x.begin() + from, x.begin() + to);
+    auto sliced = expanded | slice(from, to);
+    check_same(sliced, middle);
+
+    std::vector<int> expected;
+    for(std::size_t i = 0; i < middle.size(); i += 5) { expected.push_back(middle[i]); }
+    CHECK(values(sliced | stride(5)) == expected);
+}
+
+int main()
+{
+    round_trip_test();
+    zero_length_runs_test();
+    empty_test();
+    stride_slice_test();
+
+    return test_result();
+}
@@ -0,0 +1,198 @@
+// sorted() against std::stable_sort: signed and floating point keys, equal
+// keys (which must keep their order), inputs large enough to be radix
+// sorted on several threads, and digits that are the same for every
+// element (whose pass is skipped).
+
+#include "check.hpp"
+
+#include "range_sorted.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace adaptor;
+
+// Trivial, so that it is radix sorted by its key; index tells equal keys
+// apart.
+template <typename Key>
+struct item
+{
+    Key         key;
+    std::size_t index;
+};
+
+template <typename Key>
+bool operator==(const item<Key>& a, const item<Key>& b)
+{
+    // Compares the bits, so that -0.0 and 0.0 aren't equal.
+    return std::memcmp(&a.key, &b.key, sizeof(Key)) == 0 && a.index == b.index;
+}
+
+struct key_of
+{
+    template <typename Key>
+    Key operator()(const item<Key>& v) const
+    {
+        return v.key;
+    }
+};
+
+template <typename Key>
+std::vector<item<Key>> items(const std::vector<Key>& keys)
+{
+    std::vector<item<Key>> out;
+    for(std::size_t i = 0; i < keys.size(); ++i) { out.push_back({ keys[i], i }); }
+    return out;
+}
+
+template <typename Key>
+std::vector<item<Key>> expected(std::vector<item<Key>> x)
+{
+    std::stable_sort(x.begin(), x.end(), [](const item<Key>& a, const item<Key>& b) {
+        return a.key < b.key;
+    });
+    return x;
+}
+
+template <typename Key>
+std::vector<item<Key>> actual(std::vector<item<Key>>& x, std::size_t threads)
+{
+    std::vector<item<Key>> out;
+    for(auto& v : x | sorted(key_of(), threads)) { out.push_back(v); }
+    return out;
+}
+
+template <typename Key>
+void check_sorted(const std::vector<Key>& keys, std::size_t threads = 1)
+{
+    auto x = items(keys);
+    CHECK(actual(x, threads) == expected(x));
+}
+
+std::uint32_t next(std::uint32_t& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed;
+}
+
+void signed_test()
+{
+    std::uint32_t seed = 1;
+    std::vector<int> keys;
+    for(int i = 0; i < 10000; ++i) { keys.push_back(static_cast<int>(next(seed))); }
+    keys.push_back(std::numeric_limits<int>::min());
+    keys.push_back(std::numeric_limits<int>::max());
+    keys.push_back(-1);
+    keys.push_back(0);
+    check_sorted(keys);
+
+    std::vector<std::int8_t> small;
+    for(int i = 0; i < 1000; ++i) { small.push_back(static_cast<std::int8_t>(next(seed) >> 24)); }
+    check_sorted(small);
+
+    std::vector<std::int64_t> wide;
+    for(int i = 0; i < 1000; ++i) {
+        wide.push_back(static_cast<std::int64_t>((std::uint64_t(next(seed)) << 32) | next(seed)));
+    }
+    wide.push_back(std::numeric_limits<std::int64_t>::min());
+    check_sorted(wide);
+}
+
+void floating_point_test()
+{
+    std::uint32_t seed = 2;
+    std::vector<double> doubles{ -0.0, 0.0, -0.0, 1.0, -1.0, 0.0, -0.0,
+        std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(),
+        std::numeric_limits<double>::denorm_min(), -std::numeric_limits<double>::denorm_min(),
+        std::numeric_limits<double>::lowest(), std::numeric_limits<double>::max() };
+    for(int i = 0; i < 10000; ++i) {
+        doubles.push_back((double(next(seed)) - 2147483648.0) / 1000.0);
+    }
+    check_sorted(doubles);
+
+    std::vector<float> floats{ 0.0f, -0.0f, 0.0f, -2.5f, 2.5f, -0.0f };
+    for(int i = 0; i < 10000; ++i) {
+        floats.push_back((float(next(seed) >> 8) - 8388608.0f) / 64.0f);
+    }
+    check_sorted(floats);
+}
+
+void stable_test()
+{
+    std::uint32_t seed = 3;
+    std::vector<int> keys;
+    for(int i = 0; i < 10000; ++i) { keys.push_back(static_cast<int>(next(seed) % 16) - 8); }
+    check_sorted(keys);
+
+    check_sorted(std::vector<int>(1000, 5));
+    check_sorted(std::vector<int>());
+    check_sorted(std::vector<int>{ 1 });
+}
+
+// Every digit other than the lowest is the same for all elements, so a
+// single pass runs and the result ends up in the buffer; then with two
+// passes, and with only the top digit varying.
+void skipped_passes_test()
+{
+    std::uint32_t seed = 4;
+    std::vector<std::uint32_t> low, middle, high;
+    for(int i = 0; i < 10000; ++i) {
+        low.push_back(next(seed) >> 24);
+        middle.push_back(next(seed) & 0x00ffff00u);
+        high.push_back(0x00123456u | (next(seed) & 0xff000000u));
+    }
+    check_sorted(low);
+    check_sorted(middle);
+    check_sorted(high);
+}
+
+// At least radix_parallel_size elements, so each thread counts and moves
+// its own chunk.
+void parallel_test()
+{
+    const std::size_t n = detail::radix_parallel_size + 12345;
+    std::uint32_t seed = 5;
+
+    std::vector<int> keys(n);
+    for(auto& k : keys) { k = static_cast<int>(next(seed) % 100000) - 50000; }
+    for(std::size_t threads : { 2, 3, 4 }) {
+        check_sorted(keys, threads);
+    }
+
+    std::vector<double> doubles(n);
+    for(auto& d : doubles) { d = (double(next(seed) % 1000) - 500.0) / 4.0; }
+    doubles[n / 2] = -0.0;
+    doubles[n / 3] = 0.0;
+    check_sorted(doubles, 4);
+
+    std::vector<std::uint32_t> low(n);
+    for(auto& k : low) { k = next(seed) >> 24; }
+    check_sorted(low, 4);
+}
+
+// Keys that aren't integral or floating point are std::stable_sort()ed.
+void fallback_test()
+{
+    std::vector<int> x{ 5, 3, 9, 1, 3 };
+    std::vector<int> out;
+    for(auto v : x | sorted([](int v) { return static_cast<long double>(v); })) {
+        out.push_back(v);
+    }
+    CHECK(out == std::vector<int>({ 1, 3, 3, 5, 9 }));
+}
+
+int main()
+{
+    signed_test();
+    floating_point_test();
+    stable_test();
+    skipped_passes_test();
+    parallel_test();
+    fallback_test();
+
+    return test_result();
+}
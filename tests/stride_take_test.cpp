@@ -0,0 +1,68 @@
+// stride() and take() count positions over random access ranges and step
+// through anything else; both must give the same elements.
+
+#include "check.hpp"
+
+#include "range_map.hpp"
+#include "range_reverse.hpp"
+#include "range_stride.hpp"
+#include "range_take.hpp"
+
+#include <algorithm>
+#include <list>
+#include <vector>
+
+using namespace adaptor;
+
+template <typename Range>
+std::vector<int> elements(Range&& r)
+{
+    std::vector<int> out;
+    for(auto v : r) {
+        out.push_back(v);
+    }
+    return out;
+}
+
+int identity(int v) { return v; }
+
+int main()
+{
+    for(int n = 0; n < 40; ++n) {
+        std::vector<int> v(n);
+        for(int i = 0; i < n; ++i) { v[i] = i; }
+        std::list<int> l(v.begin(), v.end());
+
+        for(int k = 1; k < 7; ++k) {
+            std::vector<int> want;
+            for(int i = 0; i < n; i += k) { want.push_back(i); }
+
+            CHECK(elements(v | stride(k)) == want);
+            CHECK(elements(l | stride(k)) == want);
+            CHECK(elements(v | map(identity) | stride(k)).size() == want.size());
+            CHECK(elements(v | stride(k) | stride(2)).size() == (want.size() + 1) / 2);
+
+            auto s = v | stride(k);
+            CHECK(static_cast<std::size_t>(s.end() - s.begin()) == want.size());
+            CHECK(elements(s | reverse()) == std::vector<int>(want.rbegin(), want.rend()));
+            if(!want.empty()) {
+                auto last = s.end();
+                --last;
+                CHECK(*last == want.back());
+                CHECK(s.begin()[static_cast<long>(want.size()) - 1] == want.back());
+            }
+
+            auto half = s.split_range(0, want.size() / 2);
+            CHECK(static_cast<std::size_t>(half.end() - half.begin()) == want.size() / 2);
+        }
+
+        for(int t = 0; t < 45; t += 3) {
+            std::vector<int> want(v.begin(), v.begin() + std::min(n, t));
+            CHECK(elements(v | take(t)) == want);
+            CHECK(elements(l | take(t)) == want);
+            CHECK(elements(v | map(identity) | take(t)) == want);
+        }
+    }
+
+    return test_result();
+}
@@ -0,0 +1,103 @@
+// top_k and top_k_parallel against std::partial_sort.
+
+#include "check.hpp"
+
+#include "range_map.hpp"
+#include "range_top_k.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <utility>
+#include <vector>
+
+using namespace adaptor;
+
+// The first k elements of values sorted by cmp.
+template <typename T, typename Compare = std::greater<>>
+std::vector<T> expected(std::vector<T> values, std::size_t k, Compare cmp = Compare())
+{
+    k = std::min(k, values.size());
+    std::partial_sort(values.begin(), values.begin() + k, values.end(), cmp);
+    values.resize(k);
+    return values;
+}
+
+struct item
+{
+    int key;
+    int id;
+};
+
+bool by_key(const item& a, const item& b) { return a.key < b.key; }
+
+// top_k_parallel needs a splittable pipeline, not a bare container.
+template <typename T>
+T same(const T& v) { return v; }
+
+int main()
+{
+    std::uint32_t seed = 7;
+    auto next = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return seed >> 8;
+    };
+
+    for(std::size_t n : { 0, 1, 5, 100, 1000, 100000 }) {
+        std::vector<int> x(n);
+        for(auto& v : x) { v = static_cast<int>(next() % 1000) - 500; }
+        std::list<int> l(x.begin(), x.end());
+
+        for(std::size_t k : { std::size_t(0), std::size_t(1), std::size_t(10), n, n + 3 }) {
+            CHECK((x | top_k(k)) == expected(x, k));
+            CHECK((l | top_k(k)) == expected(x, k));
+            CHECK((x | top_k(k, std::less<>())) == expected(x, k, std::less<>()));
+
+            // Each thread keeps its own k best, merged at the end.
+            for(std::size_t threads : { 1, 2, 3, 8 }) {
+                CHECK((x | map(same<int>) | top_k_parallel(k, std::greater<>(), threads)) == expected(x, k));
+            }
+
+            auto twice = [](int v) { return v * 2; };
+            std::vector<int> doubled(x);
+            for(auto& v : doubled) { v *= 2; }
+            CHECK((x | map(twice) | top_k_parallel(k, std::less<>(), 4))
+                  == expected(doubled, k, std::less<>()));
+        }
+    }
+
+    // Ties: many equal keys, only the keys are compared. Which of the tied
+    // elements make it is unspecified, but the keys must match.
+    std::vector<item> items(5000);
+    for(std::size_t i = 0; i < items.size(); ++i) {
+        items[i] = item{ static_cast<int>(next() % 10), static_cast<int>(i) };
+    }
+    auto keys = [](const std::vector<item>& v) {
+        std::vector<int> out;
+        for(const auto& i : v) { out.push_back(i.key); }
+        return out;
+    };
+    for(std::size_t k : { 1, 7, 499, 500, 501, 4999, 5000 }) {
+        const auto want = keys(expected(items, k, by_key));
+        CHECK(keys(items | top_k(k, by_key)) == want);
+        CHECK(keys(items | map(same<item>) | top_k_parallel(k, by_key, 3)) == want);
+
+        // Every element returned is a distinct element of the input.
+        auto got = items | map(same<item>) | top_k_parallel(k, by_key, 4);
+        std::vector<bool> seen(items.size());
+        bool distinct = true;
+        for(const auto& i : got) {
+            distinct = distinct && items[static_cast<std::size_t>(i.id)].key == i.key && !seen[static_cast<std::size_t>(i.id)];
+            seen[static_cast<std::size_t>(i.id)] = true;
+        }
+        CHECK(distinct);
+    }
+
+    // All equal.
+    std::vector<int> threes(1000, 3);
+    CHECK((threes | top_k(10)) == std::vector<int>(10, 3));
+    CHECK((threes | map(same<int>) | top_k_parallel(10, std::greater<>(), 4)) == std::vector<int>(10, 3));
+
+    return test_result();
+}
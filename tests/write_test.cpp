@@ -0,0 +1,227 @@
+// write_to(): what is written reads back as the elements it was written
+// from, as text and as binary, to a path and to an open file, with and
+// without background writes, and with blocks small enough that elements
+// straddle them.
+
+#include "check.hpp"
+
+#include "range_map.hpp"
+#include "range_write.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace adaptor;
+
+template <typename T>
+T same(T v) { return v; }
+
+const char* path = "write_test.out";
+
+std::string read_file(const char* name)
+{
+    std::string out;
+    std::FILE* file = std::fopen(name, "rb");
+    if(file == nullptr) { return out; }
+    char buffer[4096];
+    std::size_t n;
+    while((n = std::fread(buffer, 1, sizeof(buffer), file)) != 0) { out.append(buffer, n); }
+    std::fclose(file);
+    return out;
+}
+
+std::string read_file(std::FILE* file)
+{
+    std::string out;
+    std::rewind(file);
+    char buffer[4096];
+    std::size_t n;
+    while((n = std::fread(buffer, 1, sizeof(buffer), file)) != 0) { out.append(buffer, n); }
+    return out;
+}
+
+std::vector<std::string> fields(const std::string& text, char delimiter)
+{
+    std::vector<std::string> out;
+    std::size_t start = 0;
+    for(std::size_t i = 0; i < text.size(); ++i) {
+        if(text[i] == delimiter) {
+            out.push_back(text.substr(start, i - start));
+            start = i + 1;
+        }
+    }
+    CHECK(start == text.size());
+    return out;
+}
+
+template <typename T>
+T parse(const std::string& s);
+
+template <>
+long long parse<long long>(const std::string& s) { return std::strtoll(s.c_str(), nullptr, 10); }
+template <>
+unsigned long long parse<unsigned long long>(const std::string& s) { return std::strtoull(s.c_str(), nullptr, 10); }
+template <>
+double parse<double>(const std::string& s) { return std::strtod(s.c_str(), nullptr); }
+template <>
+float parse<float>(const std::string& s) { return std::strtof(s.c_str(), nullptr); }
+
+// Parses as Parsed, which holds every value of T, and compares the bits so
+// that -0.0 and 0.0 differ.
+template <typename Parsed, typename T>
+void check_text(const std::string& text, const std::vector<T>& x, char delimiter)
+{
+    const auto values = fields(text, delimiter);
+    CHECK(values.size() == x.size());
+    for(std::size_t i = 0; i < values.size() && i < x.size(); ++i) {
+        const T value = static_cast<T>(parse<Parsed>(values[i]));
+        CHECK(std::memcmp(&value, &x[i], sizeof(T)) == 0);
+    }
+}
+
+template <typename T>
+void check_binary(const std::string& bytes, const std::vector<T>& x)
+{
+    CHECK(bytes.size() == x.size() * sizeof(T));
+    CHECK(bytes.size() == x.size() * sizeof(T) && std::memcmp(bytes.data(), x.data(), bytes.size()) == 0);
+}
+
+// Every way of writing: to a path and to an open file, in the foreground
+// and the background, with the default blocks and with blocks of 64 bytes.
+template <typename Func>
+void each_way(Func&& func)
+{
+    for(bool background : { false, true }) {
+        for(std::size_t buffer_size : { std::size_t(1) << 20, std::size_t(64) }) {
+            write_options options;
+            options.background  = background;
+            options.buffer_size = buffer_size;
+            func(options);
+        }
+    }
+}
+
+template <typename Parsed, typename T>
+void check_text_round_trip(std::vector<T> x)
+{
+    each_way([&](write_options options) {
+        options.delimiter = '\n';
+        auto stats = x | write_to<write_format::text>(path, options);
+        const auto text = read_file(path);
+        CHECK(stats.elements == x.size());
+        CHECK(stats.bytes == text.size());
+        check_text<Parsed>(text, x, '\n');
+
+        // Through a stage, to an open file, with another delimiter.
+        options.delimiter = ' ';
+        std::FILE* file = std::tmpfile();
+        CHECK(file != nullptr);
+        if(file == nullptr) { return; }
+        stats = x | map(same<T>) | write_to<write_format::text>(file, options);
+        const auto other = read_file(file);
+        std::fclose(file);
+        CHECK(stats.elements == x.size());
+        CHECK(stats.bytes == other.size());
+        check_text<Parsed>(other, x, ' ');
+    });
+}
+
+template <typename T>
+void check_binary_round_trip(std::vector<T> x)
+{
+    each_way([&](write_options options) {
+        // Contiguous, written straight from x.
+        auto stats = x | write_to(path, options);
+        CHECK(stats.elements == x.size());
+        check_binary(read_file(path), x);
+
+        // Element by element, through the blocks.
+        std::FILE* file = std::tmpfile();
+        CHECK(file != nullptr);
+        if(file == nullptr) { return; }
+        stats = x | map(same<T>) | write_to(file, options);
+        CHECK(stats.elements == x.size());
+        CHECK(stats.bytes == x.size() * sizeof(T));
+        check_binary(read_file(file), x);
+        std::fclose(file);
+    });
+}
+
+std::uint32_t next(std::uint32_t& seed)
+{
+    seed = seed * 1664525u + 1013904223u;
+    return seed;
+}
+
+void integer_test()
+{
+    std::uint32_t seed = 1;
+
+    std::vector<int> ints{ 0, 1, -1, 9, 10, -10, 99, 100, -100, 12345, -12345,
+        std::numeric_limits<int>::max(), std::numeric_limits<int>::min() };
+    for(int i = 0; i < 1000; ++i) { ints.push_back(static_cast<int>(next(seed))); }
+    check_text_round_trip<long long>(ints);
+
+    std::vector<std::int64_t> wide{ 0, -1,
+        std::numeric_limits<std::int64_t>::max(), std::numeric_limits<std::int64_t>::min() };
+    for(int i = 0; i < 1000; ++i) {
+        wide.push_back(static_cast<std::int64_t>((std::uint64_t(next(seed)) << 32) | next(seed)));
+    }
+    check_text_round_trip<long long>(wide);
+
+    std::vector<std::uint64_t> unsigned_wide{ 0, std::numeric_limits<std::uint64_t>::max() };
+    for(int i = 0; i < 100; ++i) { unsigned_wide.push_back(std::uint64_t(next(seed)) << 31); }
+    check_text_round_trip<unsigned long long>(unsigned_wide);
+
+    std::vector<signed char> small{ 0, -128, 127, -1 };
+    check_text_round_trip<long long>(small);
+}
+
+void floating_point_test()
+{
+    std::uint32_t seed = 2;
+
+    std::vector<double> doubles{ 0.0, -0.0, 0.1, -0.1, 1.0 / 3.0, 1e300, -1e-300, 123456789.0,
+        std::numeric_limits<double>::max(), std::numeric_limits<double>::lowest(),
+        std::numeric_limits<double>::min(), std::numeric_limits<double>::denorm_min() };
+    for(int i = 0; i < 1000; ++i) {
+        const auto bits = (std::uint64_t(next(seed)) << 32) | next(seed);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        if(value == value && value - value == 0) { doubles.push_back(value); }
+    }
+    check_text_round_trip<double>(doubles);
+
+    std::vector<float> floats{ 0.0f, -0.0f, 0.1f, -2.5f, 1e30f, std::numeric_limits<float>::denorm_min() };
+    for(int i = 0; i < 1000; ++i) { floats.push_back(float(next(seed)) / float(next(seed) | 1)); }
+    check_text_round_trip<float>(floats);
+}
+
+void binary_test()
+{
+    std::vector<double> doubles;
+    std::vector<std::int64_t> wide{ std::numeric_limits<std::int64_t>::min() };
+    std::uint32_t seed = 3;
+    for(int i = 0; i < 1000; ++i) {
+        doubles.push_back(double(next(seed)) / 7.0 - 1e6);
+        wide.push_back(-static_cast<std::int64_t>(next(seed)));
+    }
+    check_binary_round_trip(doubles);
+    check_binary_round_trip(wide);
+    check_binary_round_trip(std::vector<int>());
+}
+
+int main()
+{
+    integer_test();
+    floating_point_test();
+    binary_test();
+
+    std::remove(path);
+    return test_result();
+}
@@ -0,0 +1,19 @@
+// Must not compile: text output of elements that are not numbers.
+
+#include "range_write.hpp"
+
+#include <vector>
+
+struct point
+{
+    int x;
+    int y;
+};
+
+using namespace adaptor;
+
+int main()
+{
+    std::vector<point> points(4);
+    points | write_to<write_format::text>(stdout);
+}